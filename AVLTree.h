@@ -9,72 +9,269 @@
 #ifndef AVL_TREE_H
 #define AVL_TREE_H
 #include <iostream>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "NodePool.h"
 using std::cout;
 using std::endl;
 
+// ##########################################################
+// @par Name
+// usesKeyPrefix
+// @purpose
+// selects whether nodes of a key type carry a packed prefix
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// only keys whose bytes give their order benefit; integers
+// compare in one instruction and carry nothing extra
+//###########################################################
 template<class T>
-struct AVLNode
+struct usesKeyPrefix : std::false_type {};
+
+template<>
+struct usesKeyPrefix<std::string> : std::true_type {};
+
+// packed prefix of the key, kept only when usesKeyPrefix
+template<bool Stored>
+struct AVLNodePrefix
+{
+    uint64_t prefix;
+
+    uint64_t storedPrefix() const
+    {
+	   return this->prefix;
+    }
+    void storePrefix(uint64_t p)
+    {
+	   this->prefix = p;
+    }
+};
+
+template<>
+struct AVLNodePrefix<false>
+{
+    uint64_t storedPrefix() const
+    {
+	   return 0;
+    }
+    void storePrefix(uint64_t) {}
+};
+
+// the count type C is the unsigned integer each node keeps its
+// count in; members are ordered so small keys and counts pack
+// into the fewest bytes
+template<class T, class C = uint32_t>
+struct AVLNode : AVLNodePrefix<usesKeyPrefix<T>::value>
 {
+    static_assert(std::is_unsigned<C>::value, "AVLNode counts must be unsigned integers");
+
+    AVLNode<T, C> *left{};
+    AVLNode<T, C> *right{};
     T element;
-    AVLNode<T> *left{};
-    AVLNode<T> *right{};
-    int height;
-    int wordCount;
+    C wordCount;
+    int8_t height;
+};
+
+// what an insert does when a count would pass the largest value
+// of the tree's count type. Saturated counts stay at that value;
+// promoted counts keep the rest in a table beside the tree, so
+// only the few words that overflow pay for a wider count
+struct SaturateCount
+{
+    static const bool promote = false;
+};
+
+struct PromoteCount
+{
+    static const bool promote = true;
 };
 
+// ##########################################################
+// @par Name
+// keyPrefix
+// @purpose
+// packs the first bytes of a key into an integer that orders
+// the same way as the key
+// @param [in] :
+// const T &key - key to be packed
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// keys without a byte order all get 0, so comparisons always
+// fall through to the full compare
+//###########################################################
 template<class T>
+inline uint64_t keyPrefix(const T &)
+{
+    return 0;
+}
+
+inline uint64_t keyPrefix(const std::string &key)
+{
+    unsigned char bytes[8] = {};
+    std::memcpy(bytes, key.data(), key.size() < 8 ? key.size() : 8);
+    uint64_t prefix = 0;
+    for (unsigned char byte : bytes)
+	   prefix = (prefix << 8) | byte;
+    return prefix;
+}
+
+// ##########################################################
+// @par Name
+// compareKeys
+// @purpose
+// compares two keys once, giving their order
+// @param [in] :
+// const T &a - first key
+// const T &b - second key
+// @return
+// int - negative if a comes first, 0 if equal, positive if
+//	   b comes first
+// @par References
+// None
+// @par Notes
+// strings use compare() instead of two operator< calls
+//###########################################################
+template<class T>
+inline int compareKeys(const T &a, const T &b)
+{
+    return a < b ? -1 : (b < a ? 1 : 0);
+}
+
+inline int compareKeys(const std::string &a, const std::string &b)
+{
+    return a.compare(b);
+}
+
+// word and count handed back by a lookup; the word refers into
+// the tree so it stays valid until the word is removed
+template<class T>
+struct AVLEntry
+{
+    const T &element;
+    uint64_t wordCount;
+};
+
+template<class T, class C = uint32_t, class P = PromoteCount>
 class AVLTree
 {
 private:
-    AVLNode<T> *root{};
-    const T ITEM_NOT_FOUND;
+    AVLNode<T, C> *root{};
+    T ITEM_NOT_FOUND;
+    size_t numNodes{};
+    uint64_t changes{};
+    NodePool<AVLNode<T, C>> pool;
+    std::unordered_map<const AVLNode<T, C> *, uint64_t> overflow;
 
-    bool contains(T data, AVLNode<T> *r);
+    bool contains(const T &data, uint64_t prefix, AVLNode<T, C> *r) const;
 
-    void insert(const T &data, AVLNode<T> *&r) const;
-    void remove(T data, AVLNode<T> *&r) const;
-    void printTree(AVLNode<T> *r) const;
-    void makeEmpty(AVLNode<T> *&r) const;
+    AVLNode<T, C> *insert(const T &data, uint64_t prefix, uint64_t count, AVLNode<T, C> *&r);
+    void remove(T data, uint64_t prefix, AVLNode<T, C> *&r);
+    void printTree(AVLNode<T, C> *r) const;
+    void makeEmpty(AVLNode<T, C> *&r);
+    size_t memoryUsage(AVLNode<T, C> *r) const;
 
-    AVLNode<T> *findMin(AVLNode<T> *r) const;
-    AVLNode<T> *findMax(AVLNode<T> *r) const;
-    AVLNode<T> *find(const T &data, AVLNode<T> *r) const;
-    const T &elementAt(AVLNode<T> *r) const;
+    AVLNode<T, C> *findMin(AVLNode<T, C> *r) const;
+    AVLNode<T, C> *findMax(AVLNode<T, C> *r) const;
+    AVLNode<T, C> *find(const T &data, AVLNode<T, C> *r) const;
+    void lookup(AVLNode<T, C> *r, const std::vector<T> &keys, const size_t *first, const size_t *last,
+			 std::vector<std::optional<AVLEntry<T>>> &results) const;
+    const T &elementAt(AVLNode<T, C> *r) const;
 
-    AVLNode<T> *clone(AVLNode<T> *r) const;
+    AVLNode<T, C> *clone(AVLNode<T, C> *r, size_t count, const std::unordered_map<const AVLNode<T, C> *, uint64_t> &counts);
+    AVLNode<T, C> *rebuild(AVLNode<T, C> *const *nodes, size_t count);
 
     // TREE MANIPULATIONS
-    int height(AVLNode<T> *r) const;
+    int height(AVLNode<T, C> *r) const;
     int max(int lht, int rht) const;
+    int compare(const T &data, uint64_t prefix, const AVLNode<T, C> *r) const;
 
-    void rotateLeft(AVLNode<T> *&n) const;
-    void rotateRight(AVLNode<T> *&n) const;
-    void doubleRotateLeft(AVLNode<T> *&n) const;
-    void doubleRoatateRight(AVLNode<T> *&n) const;
+    void rotateLeft(AVLNode<T, C> *&n) const;
+    void rotateRight(AVLNode<T, C> *&n) const;
+    void doubleRotateLeft(AVLNode<T, C> *&n) const;
+    void doubleRoatateRight(AVLNode<T, C> *&n) const;
 
 public:
     explicit AVLTree(const T &notFound);
-    AVLTree(const AVLTree<T> &tree);
+    AVLTree(const AVLTree<T, C, P> &tree);
+    AVLTree(AVLTree<T, C, P> &&tree) noexcept;
 
     bool isEmpty() const;
+    size_t size() const;
     bool contains(T data) const;
 
     void insert(const T &data);
+    AVLNode<T, C> *insert(const T &data, uint64_t count);
+    void addCount(AVLNode<T, C> *node, uint64_t count);
+    uint64_t countOf(const AVLNode<T, C> *node) const;
     void remove(const T &data);
+    size_t removeAll(std::vector<T> keys);
     void printTree() const;
     void makeEmpty();
+    uint64_t generation() const;
 
     const T &findMin() const;
     const T &findMax() const;
     const T &find(const T &data) const;
+    std::optional<AVLEntry<T>> lookup(const T &data) const;
+    std::vector<std::optional<AVLEntry<T>>> lookup(const std::vector<T> &keys) const;
+
+    const AVLTree<T, C, P> &operator=(const AVLTree<T, C, P> &tree);
+    AVLTree<T, C, P> &operator=(AVLTree<T, C, P> &&tree) noexcept;
+    void swap(AVLTree<T, C, P> &tree) noexcept;
 
-    const AVLTree<T> &operator=(const AVLTree<T> &tree);
+    size_t memoryUsage() const;
+
+    template<class Visitor>
+    void forEach(Visitor visitor) const;
+    template<class Predicate>
+    size_t removeIf(Predicate shouldRemove);
 
     ~AVLTree();
 
 };
 
-#endif
+// ##########################################################
+// @par Name
+// heapBytes
+// @purpose
+// gets the bytes an element holds outside of its node
+// @param [in] :
+// const T &element - element to measure
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// strings only hold heap memory once they outgrow the small
+// string buffer
+//###########################################################
+template<class T>
+inline size_t heapBytes(const T &)
+{
+    return 0;
+}
+
+inline size_t heapBytes(const std::string &element)
+{
+    return element.capacity() > std::string().capacity() ? element.capacity() + 1 : 0;
+}
 
 // ##########################################################
 // @par Name
@@ -92,8 +289,8 @@ public:
 // @par Notes
 // None
 //###########################################################
-template<class T>
-AVLTree<T>::AVLTree(const T &notFound) : ITEM_NOT_FOUND(notFound), root(nullptr) {}
+template<class T, class C, class P>
+AVLTree<T, C, P>::AVLTree(const T &notFound) : root(nullptr), ITEM_NOT_FOUND(notFound), numNodes(0) {}
 
 // ##########################################################
 // @par Name
@@ -109,14 +306,36 @@ AVLTree<T>::AVLTree(const T &notFound) : ITEM_NOT_FOUND(notFound), root(nullptr)
 // const AVLTree &tree - copies an already existing tree to a
 //					newly created tree
 // @par Notes
-// None
+// the new tree starts empty so operator= never frees the
+// nodes of the tree being copied
 //###########################################################
-template<class T>
-AVLTree<T>::AVLTree(const AVLTree<T> &tree) : ITEM_NOT_FOUND(tree.ITEM_NOT_FOUND), root(tree.root)
+template<class T, class C, class P>
+AVLTree<T, C, P>::AVLTree(const AVLTree<T, C, P> &tree) : root(nullptr), ITEM_NOT_FOUND(tree.ITEM_NOT_FOUND), numNodes(0)
 {
     *this = tree;
 }
 
+// ##########################################################
+// @par Name
+// AVLTree
+// @purpose
+// takes over the nodes of an existing tree without copying
+// them
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// AVLTree &&tree - tree left empty
+// @par Notes
+// None
+//###########################################################
+template<class T, class C, class P>
+AVLTree<T, C, P>::AVLTree(AVLTree<T, C, P> &&tree) noexcept : root(nullptr), ITEM_NOT_FOUND(tree.ITEM_NOT_FOUND), numNodes(0)
+{
+    swap(tree);
+}
+
 // ##########################################################
 // @par Name
 // isEmpty
@@ -131,12 +350,32 @@ AVLTree<T>::AVLTree(const AVLTree<T> &tree) : ITEM_NOT_FOUND(tree.ITEM_NOT_FOUND
 // @par Notes
 // None
 //###########################################################
-template<class T>
-bool AVLTree<T>::isEmpty() const
+template<class T, class C, class P>
+bool AVLTree<T, C, P>::isEmpty() const
 {
     return this->root == nullptr;
 }
 
+// ##########################################################
+// @par Name
+// size
+// @purpose
+// gets the number of distinct elements in the AVLTree
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T, class C, class P>
+size_t AVLTree<T, C, P>::size() const
+{
+    return this->numNodes;
+}
+
 // ##########################################################
 // @par Name
 // contains
@@ -151,10 +390,10 @@ bool AVLTree<T>::isEmpty() const
 // @par Notes
 // None
 //###########################################################
-template<class T>
-bool AVLTree<T>::contains(T data) const
+template<class T, class C, class P>
+bool AVLTree<T, C, P>::contains(T data) const
 {
-    return this->contains(data, this->root);
+    return this->contains(data, keyPrefix(data), this->root);
 }
 
 // ################################################
@@ -171,10 +410,94 @@ bool AVLTree<T>::contains(T data) const
 // @par Notes
 // None
 //#################################################
-template<class T>
-void AVLTree<T>::insert(const T &data)
+template<class T, class C, class P>
+void AVLTree<T, C, P>::insert(const T &data)
+{
+    insert(data, keyPrefix(data), 1, this->root);
+}
+
+// ################################################
+// @par Name
+// insert
+// @purpose
+// public access to add several occurrences of data to an
+// AVLtree at once
+// @param [in] :
+// T data - data to be entered into the AVL tree
+// uint64_t count - number of occurrences to add
+// @return
+// AVLNode<T, C> * - node now holding data
+// @par References
+// None
+// @par Notes
+// one walk down the tree no matter how large count is. The
+// node stays put through later inserts and rotations, so it
+// can be cached until generation() changes
+//#################################################
+template<class T, class C, class P>
+AVLNode<T, C> *AVLTree<T, C, P>::insert(const T &data, uint64_t count)
+{
+    return insert(data, keyPrefix(data), count, this->root);
+}
+
+// ##########################################################
+// @par Name
+// addCount
+// @purpose
+// adds occurrences to the word held by a node
+// @param [in] :
+// AVLNode<T, C> *node - node returned by insert
+// uint64_t count - number of occurrences to add
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the count saturates at the largest C, or with PromoteCount
+// the rest is kept in the overflow table. Callers holding a
+// node, such as the hot word cache, count through here so the
+// policy applies to them too
+//###########################################################
+template<class T, class C, class P>
+void AVLTree<T, C, P>::addCount(AVLNode<T, C> *node, uint64_t count)
+{
+    const C limit = std::numeric_limits<C>::max();
+    if (count <= static_cast<uint64_t>(limit - node->wordCount))
+    {
+	   node->wordCount = static_cast<C>(node->wordCount + count);
+	   return;
+    }
+
+    count -= limit - node->wordCount;
+    node->wordCount = limit;
+    if constexpr (P::promote)
+	   this->overflow[node] += count;
+}
+
+// ##########################################################
+// @par Name
+// countOf
+// @purpose
+// gets the number of occurrences of the word held by a node
+// @param [in] :
+// const AVLNode<T, C> *node - node of the tree
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// only a count at the largest C looks in the overflow table
+//###########################################################
+template<class T, class C, class P>
+uint64_t AVLTree<T, C, P>::countOf(const AVLNode<T, C> *node) const
 {
-    insert(data, this->root);
+    if (P::promote && node->wordCount == std::numeric_limits<C>::max() && !this->overflow.empty())
+    {
+	   auto extra = this->overflow.find(node);
+	   if (extra != this->overflow.end())
+		  return node->wordCount + extra->second;
+    }
+    return node->wordCount;
 }
 
 // ##########################################################
@@ -191,10 +514,62 @@ void AVLTree<T>::insert(const T &data)
 // @par Notes
 // None
 //###########################################################
-template<class T>
-void AVLTree<T>::remove(const T &data)
+template<class T, class C, class P>
+void AVLTree<T, C, P>::remove(const T &data)
 {
-    remove(data, this->root);
+    this->changes++;
+    remove(data, keyPrefix(data), this->root);
+}
+
+// ##########################################################
+// @par Name
+// removeAll
+// @purpose
+// removes every listed key from the tree in one pass
+// @param [in] :
+// std::vector<T> keys - keys to be removed, in any order
+// @return
+// size_t - number of keys that were in the tree
+// @par References
+// None
+// @par Notes
+// the sorted keys are merged against the in-order walk of
+// removeIf, so a long stopword list costs O(n + k log k)
+// instead of k separate removes
+//###########################################################
+template<class T, class C, class P>
+size_t AVLTree<T, C, P>::removeAll(std::vector<T> keys)
+{
+    std::sort(keys.begin(), keys.end());
+    size_t next = 0;
+    return removeIf([&keys, &next](const T &element, uint64_t)
+    {
+	   while (next < keys.size() && compareKeys(keys[next], element) < 0)
+		  next++;
+	   return next < keys.size() && compareKeys(keys[next], element) == 0;
+    });
+}
+
+// ##########################################################
+// @par Name
+// generation
+// @purpose
+// gets a counter that changes whenever nodes may have been
+// freed or handed to another tree
+// @param [in] :
+// None
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// inserts never change it, so node pointers returned by
+// insert stay valid while it holds the same value
+//###########################################################
+template<class T, class C, class P>
+uint64_t AVLTree<T, C, P>::generation() const
+{
+    return this->changes;
 }
 
 // ##########################################################
@@ -211,8 +586,8 @@ void AVLTree<T>::remove(const T &data)
 // @par Notes
 // None
 //###########################################################
-template<class T>
-AVLTree<T>::~AVLTree()
+template<class T, class C, class P>
+AVLTree<T, C, P>::~AVLTree()
 {
     makeEmpty();
 }
@@ -224,7 +599,8 @@ AVLTree<T>::~AVLTree()
 // determines if passed data exists within the AVL Tree
 // @param [in] :
 // T data - data to be searched for
-// AVLNode<T> *r - address of root node the method searches from
+// uint64_t prefix - keyPrefix of data
+// AVLNode<T, C> *r - address of root node the method searches from
 // @return
 // bool
 // @par References
@@ -232,15 +608,17 @@ AVLTree<T>::~AVLTree()
 // @par Notes
 // None
 //###########################################################
-template<class T>
-bool AVLTree<T>::contains(T data, AVLNode<T> *r)
+template<class T, class C, class P>
+bool AVLTree<T, C, P>::contains(const T &data, uint64_t prefix, AVLNode<T, C> *r) const
 {
     if (r == nullptr)
 	   return false;
-    else if (data < r->element)
-	   return contains(data, r->left);
-    else if (data > r->element)
-	   return contains(data, r->right);
+
+    int order = compare(data, prefix, r);
+    if (order < 0)
+	   return contains(data, prefix, r->left);
+    else if (order > 0)
+	   return contains(data, prefix, r->right);
     else
 	   return true;
 }
@@ -252,44 +630,52 @@ bool AVLTree<T>::contains(T data, AVLNode<T> *r)
 // inserts data into a AVL tree
 // @param [in] :
 // T data - data to be entered into the AVL tree
-// AVLNode<T> *r - address of root node where the method attempts
+// uint64_t prefix - keyPrefix of data
+// int count - number of occurrences to add
+// AVLNode<T, C> *r - address of root node where the method attempts
 //			 to insert the passed data
 // @return
-// None
+// AVLNode<T, C> * - node now holding data
 // @par References
 // None
 // @par Notes
 // None
 //###########################################################
-template<class T>
-void AVLTree<T>::insert(const T &data, AVLNode<T> *&r) const
+template<class T, class C, class P>
+AVLNode<T, C> *AVLTree<T, C, P>::insert(const T &data, uint64_t prefix, uint64_t count, AVLNode<T, C> *&r)
 {
+    AVLNode<T, C> *node;
+    int order = r == nullptr ? 0 : compare(data, prefix, r);
     if (r == nullptr)
     {
-	   AVLNode<T> *newNode = new AVLNode<T>;
+	   AVLNode<T, C> *newNode = this->pool.create();
+	   this->numNodes++;
 	   newNode->element = data;
+	   newNode->storePrefix(prefix);
 	   newNode->left = nullptr;
 	   newNode->right = nullptr;  
-	   newNode->wordCount = 1;
+	   newNode->wordCount = 0;
+	   addCount(newNode, count);
 	   r = newNode;
+	   node = newNode;
     }
-    else if (data < r->element)
+    else if (order < 0)
     {
-	   insert(data, r->left);
+	   node = insert(data, prefix, count, r->left);
 	   if (height(r->left) - height(r->right) == 2)
 	   {
-		  if (data < r->left->element)
+		  if (compare(data, prefix, r->left) < 0)
 			 rotateRight(r);
 		  else
 			 doubleRotateLeft(r);
 	   }
     }
-    else if (data > r->element)
+    else if (order > 0)
     {
-	   insert(data, r->right);
+	   node = insert(data, prefix, count, r->right);
 	   if (height(r->right) - height(r->left) == 2)
 	   {
-		  if (data > r->right->element)
+		  if (compare(data, prefix, r->right) > 0)
 			 rotateLeft(r);
 		  else
 			 doubleRoatateRight(r);
@@ -297,11 +683,12 @@ void AVLTree<T>::insert(const T &data, AVLNode<T> *&r) const
     }
     else
     {
-	   r->wordCount++;
+	   addCount(r, count);
+	   node = r;
     }
 
-    if (r != nullptr)
-	   r->height = max(height(r->left), height(r->right)) + 1;
+    r->height = max(height(r->left), height(r->right)) + 1;
+    return node;
 }
 
 // ##########################################################
@@ -311,7 +698,7 @@ void AVLTree<T>::insert(const T &data, AVLNode<T> *&r) const
 // removes data from a AVL tree
 // @param [in] :
 // T data - data to be removed from the AVL tree
-// AVLNode<T> *r - address of root node where the method attempts
+// AVLNode<T, C> *r - address of root node where the method attempts
 //			 to remove the passed data
 // @return
 // None
@@ -320,14 +707,17 @@ void AVLTree<T>::insert(const T &data, AVLNode<T> *&r) const
 // @par Notes
 // None
 //###########################################################
-template<class T>
-void AVLTree<T>::remove(T data, AVLNode<T> *&r) const
+template<class T, class C, class P>
+void AVLTree<T, C, P>::remove(T data, uint64_t prefix, AVLNode<T, C> *&r)
 {
     if (r == nullptr)
 	   return;
-    else if (data < r->element)
+
+    int order = compare(data, prefix, r);
+    if (order < 0)
     {
-	   remove(data, r->left);
+	   remove(data, prefix, r->left);
+	   r->height = max(height(r->left), height(r->right)) + 1;
 	   if (height(r->right) - height(r->left) > 1)
 	   {
 		  if (height(r->right->right) >= height(r->right->left))
@@ -336,9 +726,10 @@ void AVLTree<T>::remove(T data, AVLNode<T> *&r) const
 			 doubleRoatateRight(r);
 	   }
     }
-    else if (data > r->element)
+    else if (order > 0)
     {
-	   remove(data, r->right);
+	   remove(data, prefix, r->right);
+	   r->height = max(height(r->left), height(r->right)) + 1;
 	   if (height(r->left) - height(r->right) > 1)
 	   {
 		  if (height(r->left->left) >= height(r->left->right))
@@ -351,21 +742,45 @@ void AVLTree<T>::remove(T data, AVLNode<T> *&r) const
     {
 	   if (r->left == nullptr || r->right == nullptr)
 	   {
-		  AVLNode<T> *temp = r->left ? r->left : r->right;
+		  AVLNode<T, C> *temp = r->left ? r->left : r->right;
 		  if (temp == nullptr)
 		  {
 			 temp = r;
 			 r = nullptr;
 		  }
 		  else
+		  {
 			 *r = *temp;
-		  delete temp;
+			 this->overflow.erase(r);
+			 auto extra = this->overflow.find(temp);
+			 if (extra != this->overflow.end())
+			 {
+				this->overflow[r] = extra->second;
+				this->overflow.erase(temp);
+			 }
+		  }
+		  this->overflow.erase(temp);
+		  this->pool.destroy(temp);
+		  this->numNodes--;
 	   }
 	   else
 	   {
-		  AVLNode<T> *temp = findMin(r->right);
+		  AVLNode<T, C> *temp = findMin(r->right);
 		  r->element = temp->element;
-		  remove(temp->element, r->right);
+		  r->storePrefix(temp->storedPrefix());
+		  r->wordCount = temp->wordCount;
+		  this->overflow.erase(r);
+		  auto extra = this->overflow.find(temp);
+		  if (extra != this->overflow.end())
+			 this->overflow[r] = extra->second;
+		  remove(temp->element, temp->storedPrefix(), r->right);
+		  if (height(r->left) - height(r->right) > 1)
+		  {
+			 if (height(r->left->left) >= height(r->left->right))
+				rotateRight(r);
+			 else
+				doubleRotateLeft(r);
+		  }
 	   }
 
 	   if (r != nullptr)
@@ -379,7 +794,7 @@ void AVLTree<T>::remove(T data, AVLNode<T> *&r) const
 // @purpose
 // displays the data from the AVL Tree to the console
 // @param [in] :
-// AVLNode<T> *r - address of root node where the method displays
+// AVLNode<T, C> *r - address of root node where the method displays
 //			 its element
 // @return
 // None
@@ -388,12 +803,12 @@ void AVLTree<T>::remove(T data, AVLNode<T> *&r) const
 // @par Notes
 // None
 //###########################################################
-template<class T>
-void AVLTree<T>::printTree(AVLNode<T> *r) const
+template<class T, class C, class P>
+void AVLTree<T, C, P>::printTree(AVLNode<T, C> *r) const
 {
     if (r != nullptr)
     {
-	   cout << r->element << " - " << r->wordCount << endl;
+	   cout << r->element << " - " << countOf(r) << endl;
 	   this->printTree(r->left);
 	   this->printTree(r->right);
     }
@@ -405,7 +820,7 @@ void AVLTree<T>::printTree(AVLNode<T> *r) const
 // @purpose
 // deletes memory from an AVLTree
 // @param [in] :
-// AVLNode<T> *r - address of root node where the method deletes
+// AVLNode<T, C> *r - address of root node where the method deletes
 //			 memory
 // @return
 // None
@@ -414,14 +829,15 @@ void AVLTree<T>::printTree(AVLNode<T> *r) const
 // @par Notes
 // None
 //###########################################################
-template<class T>
-void AVLTree<T>::makeEmpty(AVLNode<T> *&r) const
+template<class T, class C, class P>
+void AVLTree<T, C, P>::makeEmpty(AVLNode<T, C> *&r)
 {
     if (r != nullptr)
     {
 	   makeEmpty(r->left);
 	   makeEmpty(r->right);
-	   delete r;
+	   this->pool.destroy(r);
+	   this->numNodes--;
     }
     r = nullptr;
 }
@@ -432,17 +848,17 @@ void AVLTree<T>::makeEmpty(AVLNode<T> *&r) const
 // @purpose
 // finds the minimum value of a AVL tree
 // @param [in] :
-// AVLNode<T> *r - address of root node where the method searches
+// AVLNode<T, C> *r - address of root node where the method searches
 //				for the minimum value of the tree
 // @return
-// *AVLNode<T>
+// *AVLNode<T, C>
 // @par References
 // None
 // @par Notes
 // None
 //###########################################################
-template<class T>
-AVLNode<T> *AVLTree<T>::findMin(AVLNode<T> *r) const
+template<class T, class C, class P>
+AVLNode<T, C> *AVLTree<T, C, P>::findMin(AVLNode<T, C> *r) const
 {
     if (r == nullptr)
 	   return r;
@@ -457,17 +873,17 @@ AVLNode<T> *AVLTree<T>::findMin(AVLNode<T> *r) const
 // @purpose
 // finds the maximum value of a AVL tree
 // @param [in] :
-// AVLNode<T> *r - address of root node where the method searches
+// AVLNode<T, C> *r - address of root node where the method searches
 //				for the maximum value of the tree
 // @return
-// *AVLNode<T>
+// *AVLNode<T, C>
 // @par References
 // None
 // @par Notes
 // None
 //###########################################################
-template<class T>
-AVLNode<T> *AVLTree<T>::findMax(AVLNode<T> *r) const
+template<class T, class C, class P>
+AVLNode<T, C> *AVLTree<T, C, P>::findMax(AVLNode<T, C> *r) const
 {
     if (r == nullptr)
 	   return r;
@@ -483,23 +899,25 @@ AVLNode<T> *AVLTree<T>::findMax(AVLNode<T> *r) const
 // finds data in an AVL Tree
 // @param [in] :
 // T data - data to be searched for
-// AVLNode<T> *r - address of root node where the method searches
+// AVLNode<T, C> *r - address of root node where the method searches
 //				for the passed value
 // @return
-// *AVLNode<T>
+// *AVLNode<T, C>
 // @par References
 // None
 // @par Notes
 // None
 //###########################################################
-template<class T>
-AVLNode<T> *AVLTree<T>::find(const T &data, AVLNode<T> *r) const
+template<class T, class C, class P>
+AVLNode<T, C> *AVLTree<T, C, P>::find(const T &data, AVLNode<T, C> *r) const
 {
+    uint64_t prefix = keyPrefix(data);
     while (r != nullptr)
     {
-	   if (data < r->element)
+	   int order = compare(data, prefix, r);
+	   if (order < 0)
 		  r = r->left;
-	   else if (data > r->element)
+	   else if (order > 0)
 		  r = r->right;
 	   else
 		  return r;
@@ -507,22 +925,65 @@ AVLNode<T> *AVLTree<T>::find(const T &data, AVLNode<T> *r) const
     return nullptr;
 }
 
+// ##########################################################
+// @par Name
+// lookup
+// @purpose
+// answers a sorted run of queries in one walk of the tree
+// @param [in] :
+// AVLNode<T, C> *r - address of node the walk continues from
+// const std::vector<T> &keys - words being looked up
+// const size_t *first - first index of the sorted queries
+//				     that can only be below r
+// const size_t *last - end of the sorted queries below r
+// @return
+// None
+// @par References
+// std::vector<std::optional<AVLEntry<T>>> &results - gets an
+//				entry for every query that was found
+// @par Notes
+// each node splits the queries into those smaller and those
+// larger than it, so a node is visited once no matter how
+// many queries pass through it and subtrees without queries
+// are never entered
+//###########################################################
+template<class T, class C, class P>
+void AVLTree<T, C, P>::lookup(AVLNode<T, C> *r, const std::vector<T> &keys, const size_t *first, const size_t *last,
+					std::vector<std::optional<AVLEntry<T>>> &results) const
+{
+    while (r != nullptr && first != last)
+    {
+	   const size_t *mid = std::lower_bound(first, last, r->element,
+										 [&keys](size_t i, const T &element) { return keys[i] < element; });
+	   const size_t *end = mid;
+	   while (end != last && !(r->element < keys[*end]))
+	   {
+		  results[*end].emplace(AVLEntry<T>{r->element, countOf(r)});
+		  end++;
+	   }
+
+	   lookup(r->left, keys, first, mid, results);
+	   r = r->right;
+	   first = end;
+    }
+}
+
 // ##########################################################
 // @par Name
 // elementAt
 // @purpose
 // get the element of a node 
 // @param [in] :
-// AVLNode<T> *r - address of node to get element of
+// AVLNode<T, C> *r - address of node to get element of
 // @return
-// *AVLNode<T>
+// *AVLNode<T, C>
 // @par References
 // None
 // @par Notes
 // None
 //###########################################################
-template<class T>
-const T &AVLTree<T>::elementAt(AVLNode<T> *r) const
+template<class T, class C, class P>
+const T &AVLTree<T, C, P>::elementAt(AVLNode<T, C> *r) const
 {
     if (r == nullptr)
 	   return ITEM_NOT_FOUND;
@@ -536,28 +997,82 @@ const T &AVLTree<T>::elementAt(AVLNode<T> *r) const
 // @purpose
 // clones a subtree
 // @param [in] :
-// AVLNode<T> *r - address of root node to clone
+// AVLNode<T, C> *r - address of root node to clone
+// size_t count - number of nodes in the subtree
 // @return
-// *AVLNode<T>
+// *AVLNode<T, C>
 // @par References
 // None
 // @par Notes
-// None
+// copies iteratively in preorder with an explicit stack, and
+// all count nodes are allocated as one chunk of the pool
 //###########################################################
-template<class T>
-AVLNode<T> *AVLTree<T>::clone(AVLNode<T> *r) const
+template<class T, class C, class P>
+AVLNode<T, C> *AVLTree<T, C, P>::clone(AVLNode<T, C> *r, size_t count, const std::unordered_map<const AVLNode<T, C> *, uint64_t> &counts)
 {
+    AVLNode<T, C> *result = nullptr;
     if (r == nullptr)
-	   return nullptr;
-    else
+	   return result;
+
+    this->pool.reserve(count);
+    std::vector<std::pair<AVLNode<T, C> *, AVLNode<T, C> **>> pending;
+    pending.push_back({r, &result});
+    while (!pending.empty())
     {
-	   AVLNode<T> *newNode{};
-	   newNode->element = r->element;
-	   newNode->left = clone(r->left);
-	   newNode->right = clone(r->right);
-	   newNode->height = r->height;
-	   return newNode;
+	   AVLNode<T, C> *source = pending.back().first;
+	   AVLNode<T, C> **slot = pending.back().second;
+	   pending.pop_back();
+
+	   AVLNode<T, C> *newNode = this->pool.create();
+	   newNode->element = source->element;
+	   newNode->storePrefix(source->storedPrefix());
+	   newNode->height = source->height;
+	   newNode->wordCount = source->wordCount;
+	   if (!counts.empty())
+	   {
+		  auto extra = counts.find(source);
+		  if (extra != counts.end())
+			 this->overflow[newNode] = extra->second;
+	   }
+	   *slot = newNode;
+	   this->numNodes++;
+
+	   if (source->right != nullptr)
+		  pending.push_back({source->right, &newNode->right});
+	   if (source->left != nullptr)
+		  pending.push_back({source->left, &newNode->left});
     }
+    return result;
+}
+
+// ##########################################################
+// @par Name
+// rebuild
+// @purpose
+// links sorted nodes into a perfectly balanced tree
+// @param [in] :
+// AVLNode<T, C> *const *nodes - nodes in sorted order
+// size_t count - number of nodes
+// @return
+// AVLNode<T, C> * - root of the new tree
+// @par References
+// None
+// @par Notes
+// the middle node of each range becomes its root, so every
+// node is touched once and the heights differ by at most one
+//###########################################################
+template<class T, class C, class P>
+AVLNode<T, C> *AVLTree<T, C, P>::rebuild(AVLNode<T, C> *const *nodes, size_t count)
+{
+    if (count == 0)
+	   return nullptr;
+
+    size_t mid = count / 2;
+    AVLNode<T, C> *r = nodes[mid];
+    r->left = rebuild(nodes, mid);
+    r->right = rebuild(nodes + mid + 1, count - mid - 1);
+    r->height = max(height(r->left), height(r->right)) + 1;
+    return r;
 }
 
 // ##########################################################
@@ -566,16 +1081,16 @@ AVLNode<T> *AVLTree<T>::clone(AVLNode<T> *r) const
 // @purpose
 // gets the height of a node
 // @param [in] :
-// AVLNode<T> *r - address of desired node's height
+// AVLNode<T, C> *r - address of desired node's height
 // @return
-// *AVLNode<T>
+// *AVLNode<T, C>
 // @par References
 // None
 // @par Notes
 // None
 //###########################################################
-template<class T>
-int AVLTree<T>::height(AVLNode<T> *r) const
+template<class T, class C, class P>
+int AVLTree<T, C, P>::height(AVLNode<T, C> *r) const
 {
     return r == nullptr ? -1 : r->height;
 }
@@ -595,19 +1110,49 @@ int AVLTree<T>::height(AVLNode<T> *r) const
 // @par Notes
 // None
 //###########################################################
-template<class T>
-int AVLTree<T>::max(int lht, int rht) const
+template<class T, class C, class P>
+int AVLTree<T, C, P>::max(int lht, int rht) const
 {
     return lht > rht ? lht : rht;
 }
 
+// ##########################################################
+// @par Name
+// compare
+// @purpose
+// orders data against the element of a node
+// @param [in] :
+// const T &data - data being searched for
+// uint64_t prefix - keyPrefix of data
+// const AVLNode<T, C> *r - node to compare against
+// @return
+// int - negative if data goes left, 0 if it matches, positive
+//	   if it goes right
+// @par References
+// None
+// @par Notes
+// the packed prefixes settle most comparisons with a single
+// integer compare; only keys sharing their first 8 bytes fall
+// back to a full three-way compare
+//###########################################################
+template<class T, class C, class P>
+int AVLTree<T, C, P>::compare(const T &data, uint64_t prefix, const AVLNode<T, C> *r) const
+{
+    if constexpr (usesKeyPrefix<T>::value)
+    {
+	   if (prefix != r->storedPrefix())
+		  return prefix < r->storedPrefix() ? -1 : 1;
+    }
+    return compareKeys(data, r->element);
+}
+
 // ##########################################################
 // @par Name
 // rotateLeft
 // @purpose
 // Rotates binary tree node with right child
 // @param [in] :
-// AVLNode<T> *r - address of node to be rotated
+// AVLNode<T, C> *r - address of node to be rotated
 // @return
 // none
 // @par References
@@ -615,10 +1160,10 @@ int AVLTree<T>::max(int lht, int rht) const
 // @par Notes
 // None
 //###########################################################
-template<class T>
-void AVLTree<T>::rotateLeft(AVLNode<T> *&n) const
+template<class T, class C, class P>
+void AVLTree<T, C, P>::rotateLeft(AVLNode<T, C> *&n) const
 {
-    AVLNode<T> *p = n->right;
+    AVLNode<T, C> *p = n->right;
     n->right = p->left;
     p->left = n;
     n->height = max(height(n->left), height(n->right)) + 1;
@@ -632,7 +1177,7 @@ void AVLTree<T>::rotateLeft(AVLNode<T> *&n) const
 // @purpose
 // Rotates binary tree node with left child
 // @param [in] :
-// AVLNode<T> *r - address of node to be rotated
+// AVLNode<T, C> *r - address of node to be rotated
 // @return
 // none
 // @par References
@@ -640,10 +1185,10 @@ void AVLTree<T>::rotateLeft(AVLNode<T> *&n) const
 // @par Notes
 // None
 //###########################################################
-template<class T>
-void AVLTree<T>::rotateRight(AVLNode<T> *&n) const
+template<class T, class C, class P>
+void AVLTree<T, C, P>::rotateRight(AVLNode<T, C> *&n) const
 {
-    AVLNode<T> *p = n->left;
+    AVLNode<T, C> *p = n->left;
     n->left = p->right;
     p->right = n;
     n->height = max(height(n->left), height(n->right)) + 1;
@@ -657,7 +1202,7 @@ void AVLTree<T>::rotateRight(AVLNode<T> *&n) const
 // @purpose
 // double Rotates binary tree node with left heavy children
 // @param [in] :
-// AVLNode<T> *r - address of node to be rotated
+// AVLNode<T, C> *r - address of node to be rotated
 // @return
 // none
 // @par References
@@ -665,8 +1210,8 @@ void AVLTree<T>::rotateRight(AVLNode<T> *&n) const
 // @par Notes
 // None
 //###########################################################
-template<class T>
-void AVLTree<T>::doubleRotateLeft(AVLNode<T> *&n) const
+template<class T, class C, class P>
+void AVLTree<T, C, P>::doubleRotateLeft(AVLNode<T, C> *&n) const
 {
     rotateLeft(n->left);
     rotateRight(n);
@@ -678,7 +1223,7 @@ void AVLTree<T>::doubleRotateLeft(AVLNode<T> *&n) const
 // @purpose
 // double Rotates binary tree node with right heavy children
 // @param [in] :
-// AVLNode<T> *r - address of node to be rotated
+// AVLNode<T, C> *r - address of node to be rotated
 // @return
 // none
 // @par References
@@ -686,8 +1231,8 @@ void AVLTree<T>::doubleRotateLeft(AVLNode<T> *&n) const
 // @par Notes
 // None
 //###########################################################
-template<class T>
-void AVLTree<T>::doubleRoatateRight(AVLNode<T> *&n) const
+template<class T, class C, class P>
+void AVLTree<T, C, P>::doubleRoatateRight(AVLNode<T, C> *&n) const
 {
     rotateRight(n->right);
     rotateLeft(n);
@@ -708,8 +1253,8 @@ void AVLTree<T>::doubleRoatateRight(AVLNode<T> *&n) const
 // @par Notes
 // None
 //###########################################################
-template<class T>
-void AVLTree<T>::printTree() const
+template<class T, class C, class P>
+void AVLTree<T, C, P>::printTree() const
 {
     this->printTree(this->root);
 }
@@ -726,12 +1271,22 @@ void AVLTree<T>::printTree() const
 // @par References
 // None
 // @par Notes
-// None
+// elements without destructors are dropped with their chunks
+// instead of node by node
 //###########################################################
-template<class T>
-void AVLTree<T>::makeEmpty()
+template<class T, class C, class P>
+void AVLTree<T, C, P>::makeEmpty()
 {
-    makeEmpty(this->root);
+    if (std::is_trivially_destructible<T>::value)
+    {
+	   this->root = nullptr;
+	   this->numNodes = 0;
+    }
+    else
+	   makeEmpty(this->root);
+    this->overflow.clear();
+    this->changes++;
+    this->pool.release();
 }
 
 // ##########################################################
@@ -748,8 +1303,8 @@ void AVLTree<T>::makeEmpty()
 // @par Notes
 // None
 //###########################################################
-template<class T>
-const T &AVLTree<T>::findMin() const
+template<class T, class C, class P>
+const T &AVLTree<T, C, P>::findMin() const
 {
     return elementAt(findMin(this->root));
 }
@@ -768,8 +1323,8 @@ const T &AVLTree<T>::findMin() const
 // @par Notes
 // None
 //###########################################################
-template<class T>
-const T &AVLTree<T>::findMax() const
+template<class T, class C, class P>
+const T &AVLTree<T, C, P>::findMax() const
 {
     return elementAt(findMax(this->root));
 }
@@ -788,33 +1343,270 @@ const T &AVLTree<T>::findMax() const
 // @par Notes
 // None
 //###########################################################
-template<class T>
-const T &AVLTree<T>::find(const T &data) const
+template<class T, class C, class P>
+const T &AVLTree<T, C, P>::find(const T &data) const
 {
     return elementAt(find(data, this->root));
 }
 
+// ##########################################################
+// @par Name
+// lookup
+// @purpose
+// finds a word along with the number of times it was inserted
+// @param [in] :
+// const T &data - data to be searched for
+// @return
+// std::optional<AVLEntry<T>>
+// @par References
+// None
+// @par Notes
+// empty when the data is not in the tree
+//###########################################################
+template<class T, class C, class P>
+std::optional<AVLEntry<T>> AVLTree<T, C, P>::lookup(const T &data) const
+{
+    AVLNode<T, C> *node = find(data, this->root);
+    if (node == nullptr)
+	   return std::nullopt;
+    return AVLEntry<T>{node->element, countOf(node)};
+}
+
+// ##########################################################
+// @par Name
+// lookup
+// @purpose
+// finds many words at once along with their counts
+// @param [in] :
+// const std::vector<T> &keys - data to be searched for
+// @return
+// std::vector<std::optional<AVLEntry<T>>>
+// @par References
+// None
+// @par Notes
+// results line up with keys. The keys are sorted first so
+// the whole batch is answered in a single walk of the tree
+// instead of one search per key
+//###########################################################
+template<class T, class C, class P>
+std::vector<std::optional<AVLEntry<T>>> AVLTree<T, C, P>::lookup(const std::vector<T> &keys) const
+{
+    std::vector<std::optional<AVLEntry<T>>> results(keys.size());
+    std::vector<size_t> order(keys.size());
+    for (size_t i = 0; i < order.size(); i++)
+	   order[i] = i;
+    std::sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+    lookup(this->root, keys, order.data(), order.data() + order.size(), results);
+    return results;
+}
+
 // ##########################################################
 // @par Name
 // operator=
 // @purpose
 // used to clone an existing tree to another tree
 // @param [in] :
-// AVLTree<T> &tree - tree to be cloned
+// AVLTree<T, C, P> &tree - tree to be cloned
 // @return
-// AVLTree<T>
+// AVLTree<T, C, P>
 // @par References
 // None
 // @par Notes
 // None
 //###########################################################
-template<class T>
-const AVLTree<T> &AVLTree<T>::operator=(const AVLTree<T> &tree)
+template<class T, class C, class P>
+const AVLTree<T, C, P> &AVLTree<T, C, P>::operator=(const AVLTree<T, C, P> &tree)
 {
     if (this != &tree)
     {
 	   makeEmpty();
-	   this->root = clone(tree.root);
+	   this->ITEM_NOT_FOUND = tree.ITEM_NOT_FOUND;
+	   this->root = clone(tree.root, tree.numNodes, tree.overflow);
     }
     return *this;
 }
+
+// ##########################################################
+// @par Name
+// operator=
+// @purpose
+// takes over the nodes of another tree without copying them
+// @param [in] :
+// AVLTree<T, C, P> &&tree - tree receiving this tree's old nodes
+// @return
+// AVLTree<T, C, P>
+// @par References
+// None
+// @par Notes
+// O(1); the old nodes are freed when the other tree is
+//###########################################################
+template<class T, class C, class P>
+AVLTree<T, C, P> &AVLTree<T, C, P>::operator=(AVLTree<T, C, P> &&tree) noexcept
+{
+    swap(tree);
+    return *this;
+}
+
+// ##########################################################
+// @par Name
+// swap
+// @purpose
+// exchanges the contents of two trees
+// @param [in] :
+// AVLTree<T, C, P> &tree - tree to swap with
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T, class C, class P>
+void AVLTree<T, C, P>::swap(AVLTree<T, C, P> &tree) noexcept
+{
+    std::swap(this->root, tree.root);
+    std::swap(this->ITEM_NOT_FOUND, tree.ITEM_NOT_FOUND);
+    std::swap(this->numNodes, tree.numNodes);
+    this->pool.swap(tree.pool);
+    this->overflow.swap(tree.overflow);
+    this->changes++;
+    tree.changes++;
+}
+
+// ##########################################################
+// @par Name
+// memoryUsage
+// @purpose
+// estimates the bytes held by a subtree
+// @param [in] :
+// AVLNode<T, C> *r - address of root node to measure from
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// allocator overhead is not included
+//###########################################################
+template<class T, class C, class P>
+size_t AVLTree<T, C, P>::memoryUsage(AVLNode<T, C> *r) const
+{
+    if (r == nullptr)
+	   return 0;
+    return sizeof(AVLNode<T, C>) + heapBytes(r->element) + memoryUsage(r->left) + memoryUsage(r->right);
+}
+
+// ##########################################################
+// @par Name
+// memoryUsage
+// @purpose
+// public access to estimate the bytes held by the AVL tree
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T, class C, class P>
+size_t AVLTree<T, C, P>::memoryUsage() const
+{
+    return memoryUsage(this->root) + this->overflow.size() * (sizeof(std::pair<const AVLNode<T, C> *, uint64_t>) + 2 * sizeof(void *));
+}
+
+// ##########################################################
+// @par Name
+// forEach
+// @purpose
+// calls the visitor on every element and its count in sorted
+// order
+// @param [in] :
+// Visitor visitor - callable taking (const T &, int)
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// iterative in-order walk with an explicit stack
+//###########################################################
+template<class T, class C, class P>
+template<class Visitor>
+void AVLTree<T, C, P>::forEach(Visitor visitor) const
+{
+    std::vector<AVLNode<T, C> *> stack;
+    AVLNode<T, C> *r = this->root;
+    while (r != nullptr || !stack.empty())
+    {
+	   while (r != nullptr)
+	   {
+		  stack.push_back(r);
+		  r = r->left;
+	   }
+	   r = stack.back();
+	   stack.pop_back();
+	   visitor(r->element, countOf(r));
+	   r = r->right;
+    }
+}
+
+// ##########################################################
+// @par Name
+// removeIf
+// @purpose
+// removes every element the predicate selects and rebuilds
+// the rest into a balanced tree
+// @param [in] :
+// Predicate shouldRemove - callable taking (const T &, uint64_t)
+//				    and returning true for elements to remove
+// @return
+// size_t - number of elements removed
+// @par References
+// None
+// @par Notes
+// the predicate sees the elements in sorted order. One in-order
+// walk frees the removed nodes and one rebuild relinks the
+// kept ones, O(n) in all instead of a rebalancing remove per
+// element. Kept nodes stay where they are in memory
+//###########################################################
+template<class T, class C, class P>
+template<class Predicate>
+size_t AVLTree<T, C, P>::removeIf(Predicate shouldRemove)
+{
+    std::vector<AVLNode<T, C> *> kept;
+    kept.reserve(this->numNodes);
+    std::vector<AVLNode<T, C> *> stack;
+    AVLNode<T, C> *r = this->root;
+    size_t removed = 0;
+    while (r != nullptr || !stack.empty())
+    {
+	   while (r != nullptr)
+	   {
+		  stack.push_back(r);
+		  r = r->left;
+	   }
+	   r = stack.back();
+	   stack.pop_back();
+	   AVLNode<T, C> *right = r->right;
+	   if (shouldRemove(static_cast<const T &>(r->element), countOf(r)))
+	   {
+		  this->overflow.erase(r);
+		  this->pool.destroy(r);
+		  removed++;
+	   }
+	   else
+		  kept.push_back(r);
+	   r = right;
+    }
+
+    if (removed > 0)
+    {
+	   this->numNodes -= removed;
+	   this->changes++;
+	   this->root = rebuild(kept.data(), kept.size());
+    }
+    return removed;
+}
+
+#endif
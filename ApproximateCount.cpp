@@ -0,0 +1,168 @@
+//##########################################################
+// File: ApproximateCount.cpp
+// Description: This file contains the class implementation
+//			 for ApproximateCount
+//##########################################################
+
+#include "ApproximateCount.h"
+#include "Hash.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+// ##########################################################
+// @par Name
+// ApproximateCount
+// @purpose
+// creates the sketches with the requested error bounds
+// @param [in] :
+// double epsilon - count-min overestimate as a fraction of the
+//			 total word count
+// double delta - probability a count-min bound is exceeded
+// size_t topK - number of heavy hitters displayed, 0 for all
+//				that are tracked
+// unsigned precision - log2 of the HyperLogLog register count
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// memory is fixed by these parameters, not by the input
+//###########################################################
+ApproximateCount::ApproximateCount(double epsilon, double delta, size_t topK, unsigned precision)
+    : distinct(precision), frequency(epsilon, delta), heavyHitters(heavyHitterSlots(epsilon, topK)), reported(topK) {}
+
+// ##########################################################
+// @par Name
+// heavyHitterSlots
+// @purpose
+// sizes the Space-Saving table
+// @param [in] :
+// double epsilon - count-min overestimate as a fraction of the
+//			 total word count
+// size_t topK - number of heavy hitters displayed
+// @return
+// size_t
+// @par References
+// Metwally et al., Efficient computation of frequent and top-k
+// elements in data streams
+// @par Notes
+// with 1 / epsilon slots every word above epsilon of the total
+// is tracked, the same bound the count-min sketch gives. A
+// table of only k slots fills with whatever words came last
+//###########################################################
+size_t ApproximateCount::heavyHitterSlots(double epsilon, size_t topK)
+{
+    double wanted = std::ceil(1.0 / epsilon);
+    size_t slots = wanted < static_cast<double>(HEAVY_HITTER_MAX_SLOTS) ? static_cast<size_t>(wanted) : HEAVY_HITTER_MAX_SLOTS;
+    return std::max(slots, topK);
+}
+
+// ##########################################################
+// @par Name
+// add
+// @purpose
+// records one occurrence of a word in every sketch
+// @param [in] :
+// const string &word - word to record
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the word is hashed once and the hash is shared
+//###########################################################
+void ApproximateCount::add(const string &word)
+{
+    uint64_t hash = hashWord(word);
+    this->distinct.add(hash);
+    this->frequency.add(hash);
+    this->heavyHitters.add(word, hash);
+}
+
+// ##########################################################
+// @par Name
+// estimate
+// @purpose
+// estimates how many times a word appeared
+// @param [in] :
+// const string &word - word to be searched for
+// @return
+// uint64_t - never below the true count
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t ApproximateCount::estimate(const string &word) const
+{
+    return this->frequency.estimate(hashWord(word));
+}
+
+// ##########################################################
+// @par Name
+// display
+// @purpose
+// displays the estimated totals, the heavy hitters and the
+// error bounds of each estimate
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// a heavy hitter's count is the smaller of its Space-Saving
+// and count-min estimates, and only the top k are displayed
+//###########################################################
+void ApproximateCount::display() const
+{
+    double distinctWords = this->distinct.estimate();
+    double distinctError = this->distinct.relativeError();
+    cout << "total words - " << this->frequency.totalCount() << endl;
+    cout << "distinct words - ~" << static_cast<uint64_t>(distinctWords + 0.5)
+	    << " (+/- " << distinctError * 100 << "% std error)" << endl;
+    cout << "word counts overestimate by at most " << this->frequency.errorBound()
+	    << " with probability " << 1.0 - this->frequency.delta() << endl;
+    cout << "heavy hitters (count - guaranteed minimum), complete above "
+	    << this->heavyHitters.errorBound() << ":" << endl;
+
+    // both sketches only overestimate, so the smaller count is
+    // the closer one
+    vector<SpaceSavingEntry> top = this->heavyHitters.top();
+    for (SpaceSavingEntry &e : top)
+    {
+	   uint64_t low = e.wordCount - e.error;
+	   e.wordCount = std::min(e.wordCount, this->frequency.estimate(e.hash));
+	   e.error = e.wordCount - std::min(low, e.wordCount);
+    }
+    std::sort(top.begin(), top.end(), [](const SpaceSavingEntry &a, const SpaceSavingEntry &b)
+    {
+	   return a.wordCount != b.wordCount ? a.wordCount > b.wordCount : a.element < b.element;
+    });
+    size_t shown = this->reported == 0 ? top.size() : std::min(this->reported, top.size());
+    for (size_t i = 0; i < shown; i++)
+	   cout << top[i].element << " - " << top[i].wordCount << " - " << top[i].wordCount - top[i].error << endl;
+}
+
+// ##########################################################
+// @par Name
+// memoryUsage
+// @purpose
+// gets the bytes held by the sketches
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t ApproximateCount::memoryUsage() const
+{
+    return this->distinct.memoryUsage() + this->frequency.memoryUsage() + this->heavyHitters.memoryUsage();
+}
@@ -0,0 +1,40 @@
+//##########################################################
+// File: ApproximateCount.h
+// Description: This file contains the class definition for
+//			 ApproximateCount, which counts words in fixed
+//			 memory using probabilistic sketches
+//##########################################################
+
+#ifndef APPROXIMATE_COUNT_H
+#define APPROXIMATE_COUNT_H
+#include "HyperLogLog.h"
+#include "CountMinSketch.h"
+#include "SpaceSaving.h"
+#include <cstdint>
+#include <string>
+
+using std::string;
+
+// most heavy hitters tracked however small epsilon is
+const size_t HEAVY_HITTER_MAX_SLOTS = size_t(1) << 20;
+
+class ApproximateCount
+{
+private:
+    HyperLogLog distinct;
+    CountMinSketch frequency;
+    SpaceSaving heavyHitters;
+    size_t reported;
+
+    static size_t heavyHitterSlots(double epsilon, size_t topK);
+
+public:
+    ApproximateCount(double epsilon = 0.0001, double delta = 0.01, size_t topK = 100, unsigned precision = 14);
+
+    void add(const string &word);
+    uint64_t estimate(const string &word) const;
+    void display() const;
+    size_t memoryUsage() const;
+};
+
+#endif
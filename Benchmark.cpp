@@ -0,0 +1,97 @@
+//##########################################################
+// File: Benchmark.cpp
+// Description: This file contains the functions used to
+//			 compare the WordCount backends
+//##########################################################
+
+#include "Benchmark.h"
+#include "WordCount.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::setw;
+using std::vector;
+
+struct BackendInfo
+{
+    const char *name;
+    Backend backend;
+};
+
+const BackendInfo BENCH_BACKENDS[] = {
+    {"avl", AVL_TREE},
+    {"compact", COMPACT_AVL},
+    {"splay", SPLAY_TREE},
+    {"radix", RADIX_TREE},
+    {"sketch", SKETCH}
+};
+
+// number of lookups timed per backend
+const size_t BENCH_LOOKUPS = 1000000;
+
+// ##########################################################
+// @par Name
+// benchmarkBackends
+// @purpose
+// counts a file with every backend and displays the build
+// time, memory held and lookup latency of each
+// @param [in] :
+// const string &filename - name of file to be counted
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// lookups replay the file's own words in a shuffled order so
+// frequent words are queried more often
+//###########################################################
+void benchmarkBackends(const string &filename)
+{
+    vector<string> queries;
+    BlockReader file(filename);
+    Tokenizer tokenizer;
+    auto keep = [&queries](const string &word) { queries.push_back(word); };
+    const char *block;
+    size_t len;
+    while (file.next(block, len))
+	   tokenizer.feed(block, len, keep);
+    tokenizer.finish(keep);
+    if (queries.empty())
+    {
+	   cout << "File failed to open" << endl;
+	   return;
+    }
+    std::mt19937 rng(42);
+    std::shuffle(queries.begin(), queries.end(), rng);
+
+    cout << setw(8) << "backend" << setw(14) << "build ms" << setw(14) << "memory KB"
+	    << setw(14) << "lookup ns" << endl;
+
+    for (const BackendInfo &info : BENCH_BACKENDS)
+    {
+	   WordCount counter(filename, info.backend);
+
+	   auto start = std::chrono::steady_clock::now();
+	   counter.read();
+	   auto built = std::chrono::steady_clock::now();
+
+	   size_t found = 0;
+	   for (size_t i = 0; i < BENCH_LOOKUPS; i++)
+		  found += counter.contains(queries[i % queries.size()]);
+	   auto looked = std::chrono::steady_clock::now();
+
+	   double buildMs = std::chrono::duration<double, std::milli>(built - start).count();
+	   double lookupNs = std::chrono::duration<double, std::nano>(looked - built).count() / BENCH_LOOKUPS;
+	   cout << setw(8) << info.name << setw(14) << std::fixed << std::setprecision(2) << buildMs
+		   << setw(14) << counter.memoryUsage() / 1024 << setw(14) << lookupNs;
+	   if (found != BENCH_LOOKUPS)
+		  cout << "  (" << BENCH_LOOKUPS - found << " misses)";
+	   cout << endl;
+    }
+}
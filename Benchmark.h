@@ -0,0 +1,15 @@
+//##########################################################
+// File: Benchmark.h
+// Description: This file contains the functions used to
+//			 compare the WordCount backends
+//##########################################################
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+#include <string>
+
+using std::string;
+
+void benchmarkBackends(const string &filename);
+
+#endif
@@ -0,0 +1,545 @@
+//##########################################################
+// File: BlockReader.cpp
+// Description: This file contains the class implementation
+//			 for BlockReader
+//##########################################################
+
+#include "BlockReader.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ##########################################################
+// @par Name
+// BlockReader
+// @purpose
+// opens a file and starts prefetching its first blocks
+// @param [in] :
+// const string &filename - name of file to be read, "-" for
+//					  standard input
+// size_t block - bytes per block
+// size_t ringDepth - number of blocks in the ring
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// with WORDCOUNT_USE_URING defined (link with -luring) regular
+// files are read through io_uring with every free block in
+// flight; otherwise, or when io_uring cannot be set up, a
+// reader thread fills the ring. gzip and zstd input is found
+// by its magic bytes and expanded on the reader thread
+
+//###########################################################
+BlockReader::BlockReader(const string &filename, size_t block, size_t ringDepth)
+    : fd(-1), ownsFd(true), blockSize(block < 4096 ? 4096 : block), depth(ringDepth < 2 ? 2 : ringDepth),
+      head(0), filled(0), holding(false), stopping(false), error(false), format(NO_COMPRESSION)
+{
+    if (filename == "-")
+    {
+	   this->fd = STDIN_FILENO;
+	   this->ownsFd = false;
+    }
+    else
+	   this->fd = open(filename.c_str(), O_RDONLY);
+    if (this->fd < 0)
+	   return;
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(this->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    this->storage.resize(this->blockSize * this->depth);
+    this->lengths.assign(this->depth, 0);
+
+    // the magic bytes are kept in pending so pipes work too
+    char magic[4];
+    size_t magicLen = readFully(magic, sizeof(magic));
+    this->pending.assign(magic, magic + magicLen);
+    this->format = Decompressor::detect(reinterpret_cast<const unsigned char *>(magic), magicLen);
+    if (this->format != NO_COMPRESSION)
+    {
+	   this->decoder.reset(new Decompressor(this->format));
+	   this->input.resize(COMPRESSED_BLOCK_SIZE);
+	   if (!this->decoder->isSupported())
+		  this->error = true;
+    }
+
+#ifdef WORDCOUNT_USE_URING
+    this->uring = this->format == NO_COMPRESSION && startUring();
+    if (this->uring)
+	   return;
+#endif
+    this->reader = std::thread(&BlockReader::readLoop, this);
+}
+
+// ##########################################################
+// @par Name
+// ~BlockReader
+// @purpose
+// stops prefetching and closes the file
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+BlockReader::~BlockReader()
+{
+    {
+	   std::lock_guard<std::mutex> guard(this->lock);
+	   this->stopping = true;
+    }
+    this->notFull.notify_all();
+    if (this->reader.joinable())
+	   this->reader.join();
+#ifdef WORDCOUNT_USE_URING
+    if (this->uring)
+    {
+	   // reads still in flight target our buffers, wait them out
+	   for (long long result : this->results)
+	   {
+		  struct io_uring_cqe *cqe;
+		  if (result < 0 && io_uring_wait_cqe(&this->ring, &cqe) == 0)
+			 io_uring_cqe_seen(&this->ring, cqe);
+	   }
+	   io_uring_queue_exit(&this->ring);
+    }
+#endif
+    if (this->fd >= 0 && this->ownsFd)
+	   close(this->fd);
+}
+
+// ##########################################################
+// @par Name
+// isOpen
+// @purpose
+// determines if the file was opened
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool BlockReader::isOpen() const
+{
+    return this->fd >= 0;
+}
+
+// ##########################################################
+// @par Name
+// failed
+// @purpose
+// determines if a read error cut the file short
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// only meaningful once next has returned false
+//###########################################################
+bool BlockReader::failed() const
+{
+    return this->error;
+}
+
+// ##########################################################
+// @par Name
+// isSupported
+// @purpose
+// determines if this build can decode the file's format
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool BlockReader::isSupported() const
+{
+    return !this->decoder || this->decoder->isSupported();
+}
+
+// ##########################################################
+// @par Name
+// compression
+// @purpose
+// gets the compression format detected for the file
+// @param [in] :
+// None
+// @return
+// Compression
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+Compression BlockReader::compression() const
+{
+    return this->format;
+}
+
+// ##########################################################
+// @par Name
+// next
+// @purpose
+// hands the next block of the file to the caller, returning
+// the previous block to the ring
+// @param [in] :
+// const char *&data - set to the first byte of the block
+// size_t &len - set to the number of bytes in the block
+// @return
+// bool - false once the whole file has been returned
+// @par References
+// None
+// @par Notes
+// the block stays valid until the next call, while the
+// following blocks are already being read
+//###########################################################
+bool BlockReader::next(const char *&data, size_t &len)
+{
+    if (this->fd < 0)
+	   return false;
+#ifdef WORDCOUNT_USE_URING
+    if (this->uring)
+	   return nextUring(data, len);
+#endif
+
+    std::unique_lock<std::mutex> guard(this->lock);
+    if (this->holding)
+    {
+	   this->head = (this->head + 1) % this->depth;
+	   this->filled--;
+	   this->holding = false;
+	   this->notFull.notify_one();
+    }
+
+    this->notEmpty.wait(guard, [this] { return this->filled > 0; });
+    len = this->lengths[this->head];
+    if (len == 0)
+	   return false;
+
+    data = buffer(this->head);
+    this->holding = true;
+    return true;
+}
+
+// ##########################################################
+// @par Name
+// buffer
+// @purpose
+// gets the first byte of a block in the ring
+// @param [in] :
+// size_t slot - index of the block
+// @return
+// char *
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+char *BlockReader::buffer(size_t slot)
+{
+    return this->storage.data() + slot * this->blockSize;
+}
+
+// ##########################################################
+// @par Name
+// readFully
+// @purpose
+// reads until the destination is full or the file ends
+// @param [in] :
+// char *dest - where the bytes are stored
+// size_t len - bytes wanted
+// @return
+// size_t - bytes read, short only at the end of the file
+// @par References
+// None
+// @par Notes
+// bytes held back while detecting the format come first; sets
+// the error flag and stops early when read fails
+//###########################################################
+size_t BlockReader::readFully(char *dest, size_t len)
+{
+    size_t total = 0;
+    if (!this->pending.empty())
+    {
+	   total = this->pending.size() < len ? this->pending.size() : len;
+	   std::copy(this->pending.begin(), this->pending.begin() + total, dest);
+	   this->pending.erase(this->pending.begin(), this->pending.begin() + total);
+    }
+
+    while (total < len)
+    {
+	   ssize_t n = read(this->fd, dest + total, len - total);
+	   if (n < 0 && errno == EINTR)
+		  continue;
+	   if (n < 0)
+	   {
+		  this->error = true;
+		  break;
+	   }
+	   if (n == 0)
+		  break;
+	   total += static_cast<size_t>(n);
+    }
+    return total;
+}
+
+// ##########################################################
+// @par Name
+// decodeFully
+// @purpose
+// decompresses until the destination is full or the
+// compressed stream ends
+// @param [in] :
+// char *dest - where the decompressed bytes are stored
+// size_t len - bytes wanted
+// @return
+// size_t - bytes produced, short only at the end of the stream
+// @par References
+// None
+// @par Notes
+// sets the error flag when the stream is corrupt or truncated
+//###########################################################
+size_t BlockReader::decodeFully(char *dest, size_t len)
+{
+    size_t total = 0;
+    while (total < len && !this->decoder->finished())
+    {
+	   if (this->decoder->needsInput())
+	   {
+		  size_t n = readFully(this->input.data(), this->input.size());
+		  this->decoder->setInput(this->input.data(), n);
+	   }
+	   total += this->decoder->decompress(dest + total, len - total);
+    }
+    if (this->decoder->failed())
+	   this->error = true;
+    return total;
+}
+
+// ##########################################################
+// @par Name
+// readBlock
+// @purpose
+// fills one block with the next bytes of the text
+// @param [in] :
+// char *dest - where the bytes are stored
+// size_t len - bytes wanted
+// @return
+// size_t - bytes stored, 0 once the text ends
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t BlockReader::readBlock(char *dest, size_t len)
+{
+    if (this->decoder)
+	   return this->error ? 0 : decodeFully(dest, len);
+    return readFully(dest, len);
+}
+
+// ##########################################################
+// @par Name
+// readLoop
+// @purpose
+// fills free blocks of the ring in order until the file ends
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// runs on the reader thread; an empty block marks the end
+//###########################################################
+void BlockReader::readLoop()
+{
+    TraceLog::nameThread("reader");
+    size_t tail = 0;
+    while (true)
+    {
+	   {
+		  TraceSpan span("wait for free block");
+		  std::unique_lock<std::mutex> guard(this->lock);
+		  this->notFull.wait(guard, [this] { return this->stopping || this->filled < this->depth; });
+		  if (this->stopping)
+			 return;
+	   }
+
+	   size_t n;
+	   {
+		  TraceSpan span(this->decoder ? "read and decompress block" : "read block");
+		  n = readBlock(buffer(tail), this->blockSize);
+	   }
+
+	   {
+		  std::lock_guard<std::mutex> guard(this->lock);
+		  this->lengths[tail] = n;
+		  this->filled++;
+	   }
+	   this->notEmpty.notify_one();
+	   if (n == 0)
+		  return;
+	   tail = (tail + 1) % this->depth;
+    }
+}
+
+#ifdef WORDCOUNT_USE_URING
+// ##########################################################
+// @par Name
+// startUring
+// @purpose
+// sets up io_uring and queues a read for every block
+// @param [in] :
+// None
+// @return
+// bool - false when the reader thread should be used instead
+// @par References
+// None
+// @par Notes
+// pipes and terminals are left to the reader thread since
+// their reads cannot be placed at an offset
+//###########################################################
+bool BlockReader::startUring()
+{
+    struct stat info;
+    if (fstat(this->fd, &info) != 0 || !S_ISREG(info.st_mode))
+	   return false;
+    if (io_uring_queue_init(static_cast<unsigned>(this->depth), &this->ring, 0) != 0)
+	   return false;
+
+    this->fileSize = info.st_size;
+    this->nextOffset = 0;
+    this->results.assign(this->depth, -1);
+    this->offsets.assign(this->depth, 0);
+    for (size_t slot = 0; slot < this->depth; slot++)
+	   submitRead(slot);
+    io_uring_submit(&this->ring);
+    return true;
+}
+
+// ##########################################################
+// @par Name
+// submitRead
+// @purpose
+// queues a read of the next unread block of the file
+// @param [in] :
+// size_t slot - block of the ring to read into
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// a slot past the end of the file is completed as empty
+// without a read. When the submission queue is full the queued
+// reads are submitted to make room; if there is still none the
+// slot is completed as empty and nextUring reads the block
+// with pread instead
+//###########################################################
+void BlockReader::submitRead(size_t slot)
+{
+    this->offsets[slot] = this->nextOffset;
+    if (this->nextOffset >= this->fileSize)
+    {
+	   this->results[slot] = 0;
+	   return;
+    }
+
+    struct io_uring_sqe *sqe = io_uring_get_sqe(&this->ring);
+    if (sqe == nullptr)
+    {
+	   io_uring_submit(&this->ring);
+	   sqe = io_uring_get_sqe(&this->ring);
+    }
+    if (sqe == nullptr)
+    {
+	   this->results[slot] = 0;
+	   this->nextOffset += static_cast<long long>(this->blockSize);
+	   return;
+    }
+    io_uring_prep_read(sqe, this->fd, buffer(slot), static_cast<unsigned>(this->blockSize), this->nextOffset);
+    io_uring_sqe_set_data(sqe, reinterpret_cast<void *>(slot));
+    this->results[slot] = -1;
+    this->nextOffset += static_cast<long long>(this->blockSize);
+}
+
+// ##########################################################
+// @par Name
+// nextUring
+// @purpose
+// waits for the read of the next block in file order
+// @param [in] :
+// const char *&data - set to the first byte of the block
+// size_t &len - set to the number of bytes in the block
+// @return
+// bool - false once the whole file has been returned
+// @par References
+// None
+// @par Notes
+// completions can arrive out of order, so each one is parked
+// in results until its block is next; a short read that is not
+// at the end of the file is finished with pread
+//###########################################################
+bool BlockReader::nextUring(const char *&data, size_t &len)
+{
+    if (this->holding)
+    {
+	   submitRead(this->head);
+	   io_uring_submit(&this->ring);
+	   this->head = (this->head + 1) % this->depth;
+	   this->holding = false;
+    }
+
+    while (this->results[this->head] < 0)
+    {
+	   struct io_uring_cqe *cqe;
+	   if (io_uring_wait_cqe(&this->ring, &cqe) != 0)
+	   {
+		  this->error = true;
+		  return false;
+	   }
+	   size_t slot = reinterpret_cast<size_t>(io_uring_cqe_get_data(cqe));
+	   this->results[slot] = cqe->res < 0 ? 0 : cqe->res;
+	   if (cqe->res < 0)
+		  this->error = true;
+	   io_uring_cqe_seen(&this->ring, cqe);
+    }
+
+    size_t got = static_cast<size_t>(this->results[this->head]);
+    long long offset = this->offsets[this->head];
+    long long want = this->fileSize - offset;
+    if (want > static_cast<long long>(this->blockSize))
+	   want = static_cast<long long>(this->blockSize);
+    while (!this->error && static_cast<long long>(got) < want)
+    {
+	   ssize_t n = pread(this->fd, buffer(this->head) + got, static_cast<size_t>(want) - got, offset + got);
+	   if (n < 0 && errno == EINTR)
+		  continue;
+	   if (n <= 0)
+		  break;
+	   got += static_cast<size_t>(n);
+    }
+
+    if (got == 0)
+	   return false;
+    data = buffer(this->head);
+    len = got;
+    this->holding = true;
+    return true;
+}
+#endif
@@ -0,0 +1,90 @@
+//##########################################################
+// File: BlockReader.h
+// Description: This file contains the class definition for
+//			 BlockReader, which prefetches large blocks of
+//			 a file into a ring of buffers
+//##########################################################
+
+#ifndef BLOCK_READER_H
+#define BLOCK_READER_H
+#include "Decompressor.h"
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef WORDCOUNT_USE_URING
+#include <liburing.h>
+#endif
+
+using std::string;
+using std::vector;
+
+// default size of one prefetched block
+const size_t READ_BLOCK_SIZE = 1 << 20;
+// default number of blocks in the ring
+const size_t READ_DEPTH = 4;
+// compressed bytes read at a time when decompressing
+const size_t COMPRESSED_BLOCK_SIZE = 256 << 10;
+
+class BlockReader
+{
+private:
+    int fd;
+    bool ownsFd;
+    size_t blockSize;
+    size_t depth;
+    vector<char> storage;
+    vector<size_t> lengths;
+    size_t head;
+    size_t filled;
+    bool holding;
+    bool stopping;
+    bool error;
+
+    Compression format;
+    std::unique_ptr<Decompressor> decoder;
+    vector<char> pending;
+    vector<char> input;
+
+    std::thread reader;
+    std::mutex lock;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+
+#ifdef WORDCOUNT_USE_URING
+    bool uring;
+    struct io_uring ring;
+    vector<long long> results;
+    long long fileSize;
+    long long nextOffset;
+    vector<long long> offsets;
+
+    bool startUring();
+    void submitRead(size_t slot);
+    bool nextUring(const char *&data, size_t &len);
+#endif
+
+    char *buffer(size_t slot);
+    size_t readFully(char *dest, size_t len);
+    size_t decodeFully(char *dest, size_t len);
+    size_t readBlock(char *dest, size_t len);
+    void readLoop();
+
+public:
+    explicit BlockReader(const string &filename, size_t block = READ_BLOCK_SIZE, size_t ringDepth = READ_DEPTH);
+    BlockReader(const BlockReader &other) = delete;
+    BlockReader &operator=(const BlockReader &other) = delete;
+
+    bool isOpen() const;
+    bool failed() const;
+    bool isSupported() const;
+    Compression compression() const;
+    bool next(const char *&data, size_t &len);
+
+    ~BlockReader();
+};
+
+#endif
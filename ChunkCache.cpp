@@ -0,0 +1,342 @@
+//##########################################################
+// File: ChunkCache.cpp
+// Description: This file contains the class implementations
+//			 for ContentChunker and ChunkCache
+//##########################################################
+
+#include "ChunkCache.h"
+#include "Hash.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <unistd.h>
+
+using std::cout;
+using std::endl;
+
+// seeds the chunk hash; change it when the tokenizer changes
+// so that entries counted by the old rules are not reused
+const uint64_t CHUNK_CACHE_VERSION = 1;
+
+// ##########################################################
+// @par Name
+// ContentChunker
+// @purpose
+// creates a chunker at the start of a text
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+ContentChunker::ContentChunker() : gear(0), cutting(false) {}
+
+// ##########################################################
+// @par Name
+// gearTable
+// @purpose
+// gets the random value added to the rolling hash per byte
+// @param [in] :
+// None
+// @return
+// const uint64_t * - 256 entries
+// @par References
+// None
+// @par Notes
+// derived from mixHash so every build cuts at the same places
+// and keeps finding the entries stored by the others
+//###########################################################
+const uint64_t *ContentChunker::gearTable()
+{
+    struct GearTable
+    {
+	   uint64_t values[256];
+	   GearTable()
+	   {
+		  for (int i = 0; i < 256; i++)
+			 values[i] = mixHash(uint64_t(i) + 0x9E3779B97F4A7C15ULL);
+	   }
+    };
+    static const GearTable table;
+    return table.values;
+}
+
+// ##########################################################
+// @par Name
+// ChunkCache
+// @purpose
+// creates a cache of chunk counts in a directory
+// @param [in] :
+// const string &directory - directory holding the entries,
+//				     created if missing
+// uint64_t maxBytes - size evict brings the entries down to
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// a directory may be shared by several files or versions of a
+// file; evict keeps it near maxBytes
+//###########################################################
+ChunkCache::ChunkCache(const string &directory, uint64_t maxBytes)
+    : dir(directory), limit(maxBytes), hits(0), misses(0), evicted(0), reusedBytes(0), scannedBytes(0)
+{
+    std::error_code error;
+    std::filesystem::create_directories(this->dir, error);
+}
+
+// ##########################################################
+// @par Name
+// directory
+// @purpose
+// gets the directory holding the entries
+// @param [in] :
+// None
+// @return
+// const string &
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+const string &ChunkCache::directory() const
+{
+    return this->dir;
+}
+
+// ##########################################################
+// @par Name
+// sizeLimit
+// @purpose
+// gets the size evict brings the entries down to
+// @param [in] :
+// None
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t ChunkCache::sizeLimit() const
+{
+    return this->limit;
+}
+
+// ##########################################################
+// @par Name
+// hitCount
+// @purpose
+// gets the number of chunks read back from the cache
+// @param [in] :
+// None
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t ChunkCache::hitCount() const
+{
+    return this->hits;
+}
+
+// ##########################################################
+// @par Name
+// missCount
+// @purpose
+// gets the number of chunks that had to be tokenized
+// @param [in] :
+// None
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t ChunkCache::missCount() const
+{
+    return this->misses;
+}
+
+// ##########################################################
+// @par Name
+// display
+// @purpose
+// displays how much of the text was reused from the cache
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void ChunkCache::display() const
+{
+    cout << "chunk hits - " << this->hits << " (" << this->reusedBytes << " bytes)" << endl;
+    cout << "chunk misses - " << this->misses << " (" << this->scannedBytes << " bytes)" << endl;
+    cout << "chunk evictions - " << this->evicted << endl;
+}
+
+// ##########################################################
+// @par Name
+// entryPath
+// @purpose
+// names the count file of a chunk
+// @param [in] :
+// const char *data - bytes of the chunk
+// size_t len - number of bytes in the chunk
+// @return
+// string
+// @par References
+// None
+// @par Notes
+// the name holds a 64 bit hash of the bytes and their length
+//###########################################################
+string ChunkCache::entryPath(const char *data, size_t len) const
+{
+    char name[64];
+    std::snprintf(name, sizeof(name), "/%016" PRIx64 "-%zu.cnt", hashBytes(data, len, CHUNK_CACHE_VERSION), len);
+    return this->dir + name;
+}
+
+// ##########################################################
+// @par Name
+// load
+// @purpose
+// reads the stored counts of a chunk into entries
+// @param [in] :
+// const string &path - count file of the chunk
+// @return
+// bool - true if the whole file was read
+// @par References
+// None
+// @par Notes
+// a missing or damaged entry is treated as a miss and is
+// written again
+//###########################################################
+bool ChunkCache::load(const string &path)
+{
+    this->entries.clear();
+    CountFileReader file(path);
+    if (!file.isOpen())
+	   return false;
+
+    string word;
+    uint64_t count;
+    while (file.next(word, count))
+	   this->entries.emplace_back(word, count);
+    return !file.failed();
+}
+
+// ##########################################################
+// @par Name
+// store
+// @purpose
+// writes the counts of a chunk to its count file
+// @param [in] :
+// const string &path - count file of the chunk
+// const AVLTree<string> &counts - counts of the chunk
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the file is written under a temporary name and renamed, so a
+// concurrent run never reads a half written entry. A failed
+// write only costs the next run a rescan of the chunk
+//###########################################################
+void ChunkCache::store(const string &path, const AVLTree<string> &counts)
+{
+    string temp = path + "." + std::to_string(getpid()) + ".tmp";
+    CountFileWriter writer(temp);
+    counts.forEach([&writer](const string &word, uint64_t count) { writer.write(word, count); });
+    if (!writer.close() || std::rename(temp.c_str(), path.c_str()) != 0)
+	   std::remove(temp.c_str());
+}
+
+// ##########################################################
+// @par Name
+// touch
+// @purpose
+// marks an entry as just used
+// @param [in] :
+// const string &path - count file of the chunk
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the modification time is the last use; a failure only makes
+// the entry look older to evict
+//###########################################################
+void ChunkCache::touch(const string &path)
+{
+    std::error_code error;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+}
+
+// ##########################################################
+// @par Name
+// evict
+// @purpose
+// removes the least recently used entries until the directory
+// holds at most the size limit
+// @param [in] :
+// None
+// @return
+// size_t - number of entries removed
+// @par References
+// None
+// @par Notes
+// entries this cache used are kept even past the limit, since
+// the next read of the same text wants them. Temporary files
+// of runs still writing are left alone
+//###########################################################
+size_t ChunkCache::evict()
+{
+    struct Entry
+    {
+	   std::filesystem::file_time_type time;
+	   uint64_t size;
+	   string path;
+    };
+    vector<Entry> stale;
+    uint64_t total = 0;
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(this->dir, error), end; !error && it != end; it.increment(error))
+    {
+	   std::error_code failed;
+	   if (it->path().extension() != ".cnt" || !it->is_regular_file(failed))
+		  continue;
+	   uint64_t size = it->file_size(failed);
+	   std::filesystem::file_time_type time = it->last_write_time(failed);
+	   if (failed)
+		  continue;
+	   total += size;
+	   string path = it->path().string();
+	   if (this->used.count(path) == 0)
+		  stale.push_back(Entry{time, size, path});
+    }
+
+    std::sort(stale.begin(), stale.end(), [](const Entry &a, const Entry &b) { return a.time < b.time; });
+    size_t removed = 0;
+    for (size_t i = 0; i < stale.size() && total > this->limit; i++)
+    {
+	   if (!std::filesystem::remove(stale[i].path, error))
+		  continue;
+	   total -= stale[i].size;
+	   removed++;
+    }
+    this->evicted += removed;
+    return removed;
+}
@@ -0,0 +1,237 @@
+//##########################################################
+// File: ChunkCache.h
+// Description: This file contains the class definitions for
+//			 ContentChunker, which splits text into chunks
+//			 at content defined boundaries, and ChunkCache,
+//			 which keeps the word counts of each chunk on
+//			 disk keyed by its content
+//##########################################################
+
+#ifndef CHUNK_CACHE_H
+#define CHUNK_CACHE_H
+#include "AVLTree.h"
+#include "CountFile.h"
+#include "Tokenizer.h"
+#include "WordBuffer.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+// smallest chunk, boundaries are never looked for before it
+const size_t CHUNK_MIN_SIZE = 1 << 14;
+// largest chunk before the next separator is taken as a cut
+const size_t CHUNK_MAX_SIZE = 1 << 18;
+// a cut is made where these bits of the rolling hash are zero,
+// giving chunks of about CHUNK_MIN_SIZE + 64KiB on average. The
+// top bits depend on the whole window, the low ones only on the
+// last few bytes
+const uint64_t CHUNK_MASK = ~uint64_t(0) << 48;
+// bytes that fall out of the rolling hash, one bit per byte
+const size_t CHUNK_WINDOW = 64;
+// bytes of entries a cache directory keeps by default before
+// the least recently used ones are removed
+const uint64_t CHUNK_CACHE_LIMIT = uint64_t(1) << 30;
+
+class ContentChunker
+{
+private:
+    static const uint64_t *gearTable();
+
+    vector<char> carry;
+    uint64_t gear;
+    bool cutting;
+
+public:
+    ContentChunker();
+
+    template<class Callback>
+    void feed(const char *data, size_t len, Callback &&callback);
+    template<class Callback>
+    void finish(Callback &&callback);
+};
+
+class ChunkCache
+{
+private:
+    string dir;
+    uint64_t limit;
+    vector<std::pair<string, uint64_t>> entries;
+    // entries read or written by this cache, never evicted by it
+    std::unordered_set<string> used;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evicted;
+    uint64_t reusedBytes;
+    uint64_t scannedBytes;
+
+    string entryPath(const char *data, size_t len) const;
+    bool load(const string &path);
+    static void store(const string &path, const AVLTree<string> &counts);
+    static void touch(const string &path);
+
+public:
+    explicit ChunkCache(const string &directory, uint64_t maxBytes = CHUNK_CACHE_LIMIT);
+
+    template<class Sink>
+    void count(const char *data, size_t len, Sink &&sink);
+
+    size_t evict();
+
+    const string &directory() const;
+    uint64_t sizeLimit() const;
+    uint64_t hitCount() const;
+    uint64_t missCount() const;
+    void display() const;
+};
+
+// ##########################################################
+// @par Name
+// feed
+// @purpose
+// splits the next block of text into chunks
+// @param [in] :
+// const char *data - bytes of the block
+// size_t len - number of bytes in the block
+// Callback &&callback - callable taking (const char *, size_t)
+//			    for each complete chunk
+// @return
+// None
+// @par References
+// Xia et al., FastCDC: a Fast and Efficient Content-Defined
+// Chunking Approach for Data Deduplication
+// @par Notes
+// a gear hash of the last CHUNK_WINDOW bytes picks the cuts,
+// so an edit only moves the boundaries next to it. The cut is
+// made at the first separator after the hash picks a place, so
+// no word spans two chunks.
+// The hash is skipped until the chunk nears CHUNK_MIN_SIZE,
+// and a chunk inside one block is passed without a copy
+//###########################################################
+template<class Callback>
+void ContentChunker::feed(const char *data, size_t len, Callback &&callback)
+{
+    const uint64_t *table = gearTable();
+    const CharClass *classes = Tokenizer::classes();
+    const char *start = data;
+    const char *p = data;
+    const char *end = data + len;
+    while (p < end)
+    {
+	   size_t size = this->carry.size() + (p - start);
+	   if (size + CHUNK_WINDOW < CHUNK_MIN_SIZE)
+	   {
+		  size_t skip = CHUNK_MIN_SIZE - CHUNK_WINDOW - size;
+		  p += skip < size_t(end - p) ? skip : size_t(end - p);
+		  continue;
+	   }
+
+	   uint8_t c = static_cast<uint8_t>(*p++);
+	   this->gear = (this->gear << 1) + table[c];
+	   if (size + 1 < CHUNK_MIN_SIZE)
+		  continue;
+	   if ((this->gear & CHUNK_MASK) == 0 || size + 1 >= CHUNK_MAX_SIZE)
+		  this->cutting = true;
+	   if (!this->cutting || classes[c] != SEPARATOR)
+		  continue;
+
+	   if (this->carry.empty())
+		  callback(static_cast<const char *>(start), static_cast<size_t>(p - start));
+	   else
+	   {
+		  this->carry.insert(this->carry.end(), start, p);
+		  callback(static_cast<const char *>(this->carry.data()), this->carry.size());
+		  this->carry.clear();
+	   }
+	   start = p;
+	   this->gear = 0;
+	   this->cutting = false;
+    }
+    this->carry.insert(this->carry.end(), start, end);
+}
+
+// ##########################################################
+// @par Name
+// finish
+// @purpose
+// passes the chunk left at the end of the text, if any, to the
+// callback
+// @param [in] :
+// Callback &&callback - callable taking (const char *, size_t)
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class Callback>
+void ContentChunker::finish(Callback &&callback)
+{
+    if (!this->carry.empty())
+	   callback(static_cast<const char *>(this->carry.data()), this->carry.size());
+    this->carry.clear();
+    this->gear = 0;
+    this->cutting = false;
+}
+
+// ##########################################################
+// @par Name
+// count
+// @purpose
+// passes the word counts of one chunk to a sink
+// @param [in] :
+// const char *data - bytes of the chunk
+// size_t len - number of bytes in the chunk
+// Sink &&sink - callable taking (const string &, uint64_t) once
+//			 per distinct word, in increasing word order
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// a chunk seen before is read back from its count file and not
+// tokenized, and the file is touched so eviction sees it as
+// recently used. A new chunk is counted the same way read
+// counts a file and its counts are stored for the next run
+//###########################################################
+template<class Sink>
+void ChunkCache::count(const char *data, size_t len, Sink &&sink)
+{
+    string path = entryPath(data, len);
+    this->used.insert(path);
+    if (load(path))
+    {
+	   touch(path);
+	   this->hits++;
+	   this->reusedBytes += len;
+	   for (const std::pair<string, uint64_t> &entry : this->entries)
+		  sink(entry.first, entry.second);
+	   return;
+    }
+    this->misses++;
+    this->scannedBytes += len;
+
+    Tokenizer tokenizer;
+    WordBuffer buffer;
+    AVLTree<string> counts("");
+    auto flush = [&counts](const string &word, uint64_t, uint64_t count) { counts.insert(word, count); };
+    auto add = [&buffer, &flush](const string &word)
+    {
+	   if (buffer.add(word))
+		  buffer.flush(flush);
+    };
+    tokenizer.feed(data, len, add);
+    tokenizer.finish(add);
+    buffer.flush(flush);
+
+    store(path, counts);
+    counts.forEach([&sink](const string &word, uint64_t count) { sink(word, count); });
+}
+
+#endif
@@ -0,0 +1,768 @@
+//##########################################################
+// File: CompactAVLTree.h
+// Description: This file contains the CompactAVLTree template
+//			 class, an AVL tree whose nodes live in one
+//			 array and link to each other by index
+//##########################################################
+
+#ifndef COMPACT_AVL_TREE_H
+#define COMPACT_AVL_TREE_H
+#include "AVLTree.h"
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// index standing in for a null child, so a tree holds at most
+// COMPACT_NIL words
+const uint32_t COMPACT_NIL = 0xFFFFFFFF;
+
+// an AVL tree of 2^32 nodes is at most 46 levels deep
+const int COMPACT_MAX_HEIGHT = 64;
+
+// keys of a CompactAVLTree stored apart from its nodes, in the
+// same order as the nodes
+template<class T>
+class CompactKeys
+{
+private:
+    std::vector<T> keys;
+
+public:
+    void push(const T &key) { this->keys.push_back(key); }
+    const T &at(uint32_t i) const { return this->keys[i]; }
+    int compare(const T &data, uint32_t i) const { return compareKeys(data, this->keys[i]); }
+    void reserve(size_t n) { this->keys.reserve(n); }
+    void shrinkToFit() { this->keys.shrink_to_fit(); }
+    void clear() { std::vector<T>().swap(this->keys); }
+
+    size_t memoryUsage() const
+    {
+	   size_t bytes = this->keys.capacity() * sizeof(T);
+	   for (const T &key : this->keys)
+		  bytes += heapBytes(key);
+	   return bytes;
+    }
+};
+
+// strings are packed back to back in one character array, so a
+// key costs its length plus an 8 byte offset instead of a whole
+// std::string and its heap block. The offsets are 64 bits since
+// a large corpus can pass 4GiB of distinct words
+template<>
+class CompactKeys<std::string>
+{
+private:
+    std::vector<char> bytes;
+    std::vector<uint64_t> offsets{0};
+
+public:
+    void push(const std::string &key)
+    {
+	   this->bytes.insert(this->bytes.end(), key.begin(), key.end());
+	   this->offsets.push_back(this->bytes.size());
+    }
+
+    std::string_view at(uint32_t i) const
+    {
+	   return std::string_view(this->bytes.data() + this->offsets[i], this->offsets[i + 1] - this->offsets[i]);
+    }
+
+    int compare(const std::string &data, uint32_t i) const { return std::string_view(data).compare(at(i)); }
+
+    void reserve(size_t n) { this->offsets.reserve(n + 1); }
+
+    void shrinkToFit()
+    {
+	   this->bytes.shrink_to_fit();
+	   this->offsets.shrink_to_fit();
+    }
+
+    void clear()
+    {
+	   std::vector<char>().swap(this->bytes);
+	   this->offsets.assign(1, 0);
+    }
+
+    size_t memoryUsage() const { return this->bytes.capacity() + this->offsets.capacity() * sizeof(uint64_t); }
+};
+
+template<class T>
+class CompactAVLTree
+{
+private:
+    // only the fields touched while walking down the tree; the
+    // keys sit in a parallel array and are read on prefix ties
+    struct Node
+    {
+	   uint64_t prefix;
+	   uint32_t left;
+	   uint32_t right;
+	   uint32_t wordCount;
+	   int8_t balance;
+    };
+
+    std::vector<Node> nodes;
+    CompactKeys<T> keys;
+    uint32_t root;
+    // occurrences past the largest uint32_t count of a node, so
+    // only the few words that overflow pay for a wider count
+    std::unordered_map<uint32_t, uint64_t> overflow;
+
+    void addCount(uint32_t n, uint64_t count);
+    uint64_t countOf(uint32_t n) const;
+    int compare(const T &data, uint64_t prefix, uint32_t n) const;
+    void printTree(uint32_t n) const;
+
+    // TREE MANIPULATIONS
+    void link(uint32_t parent, bool right, uint32_t child);
+    uint32_t rotateLeft(uint32_t n);
+    uint32_t rotateRight(uint32_t n);
+    uint32_t rebalance(uint32_t n);
+
+public:
+    CompactAVLTree();
+
+    bool isEmpty() const;
+    size_t size() const;
+    bool contains(const T &data) const;
+    uint64_t count(const T &data) const;
+    uint32_t find(const T &data) const;
+
+    uint32_t insert(const T &data, uint64_t count = 1);
+    void reserve(size_t n);
+    void shrinkToFit();
+    void printTree() const;
+    void makeEmpty();
+
+    size_t memoryUsage() const;
+
+    template<class Visitor>
+    void forEach(Visitor visitor) const;
+    template<class Visitor>
+    void forEachIndexed(Visitor visitor) const;
+};
+
+// ##########################################################
+// @par Name
+// CompactAVLTree
+// @purpose
+// creates an empty tree
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+CompactAVLTree<T>::CompactAVLTree() : root(COMPACT_NIL) {}
+
+// ##########################################################
+// @par Name
+// isEmpty
+// @purpose
+// determines if the tree is empty or not
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+bool CompactAVLTree<T>::isEmpty() const
+{
+    return this->root == COMPACT_NIL;
+}
+
+// ##########################################################
+// @par Name
+// size
+// @purpose
+// gets the number of distinct elements in the tree
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+size_t CompactAVLTree<T>::size() const
+{
+    return this->nodes.size();
+}
+
+// ##########################################################
+// @par Name
+// contains
+// @purpose
+// determines if passed data exists within the tree
+// @param [in] :
+// const T &data - data to be searched for
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+bool CompactAVLTree<T>::contains(const T &data) const
+{
+    return find(data) != COMPACT_NIL;
+}
+
+// ##########################################################
+// @par Name
+// count
+// @purpose
+// gets the number of times data was inserted
+// @param [in] :
+// const T &data - data to be searched for
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// 0 when the data is not in the tree
+//###########################################################
+template<class T>
+uint64_t CompactAVLTree<T>::count(const T &data) const
+{
+    uint32_t n = find(data);
+    return n == COMPACT_NIL ? 0 : countOf(n);
+}
+
+// ##########################################################
+// @par Name
+// insert
+// @purpose
+// adds occurrences of data to the tree
+// @param [in] :
+// const T &data - data to be entered into the tree
+// uint64_t count - number of occurrences to add
+// @return
+// uint32_t - index of the node holding data
+// @par References
+// None
+// @par Notes
+// iterative: the path down is kept on the stack and balance
+// factors are fixed on the way back up, stopping at the first
+// node whose height did not change. At most one rotation is
+// needed after an insert. Node indices stay valid for the
+// life of the tree since nodes are never moved or removed.
+// Throws std::length_error rather than hand out COMPACT_NIL as
+// the index of a new word
+//###########################################################
+template<class T>
+uint32_t CompactAVLTree<T>::insert(const T &data, uint64_t count)
+{
+    uint64_t prefix = keyPrefix(data);
+    uint32_t path[COMPACT_MAX_HEIGHT];
+    bool wentRight[COMPACT_MAX_HEIGHT];
+    int depth = 0;
+
+    uint32_t n = this->root;
+    while (n != COMPACT_NIL)
+    {
+	   int order = compare(data, prefix, n);
+	   if (order == 0)
+	   {
+		  addCount(n, count);
+		  return n;
+	   }
+	   path[depth] = n;
+	   wentRight[depth] = order > 0;
+	   depth++;
+	   n = order < 0 ? this->nodes[n].left : this->nodes[n].right;
+    }
+
+    if (this->nodes.size() >= COMPACT_NIL)
+	   throw std::length_error("CompactAVLTree holds at most 2^32 - 1 words");
+    uint32_t added = static_cast<uint32_t>(this->nodes.size());
+    this->nodes.push_back(Node{prefix, COMPACT_NIL, COMPACT_NIL, 0, 0});
+    this->keys.push(data);
+    addCount(added, count);
+    if (depth == 0)
+    {
+	   this->root = added;
+	   return added;
+    }
+    link(path[depth - 1], wentRight[depth - 1], added);
+
+    for (int i = depth - 1; i >= 0; i--)
+    {
+	   Node &node = this->nodes[path[i]];
+	   node.balance += wentRight[i] ? 1 : -1;
+	   if (node.balance == 0)
+		  break;
+	   if (node.balance == 1 || node.balance == -1)
+		  continue;
+
+	   uint32_t top = rebalance(path[i]);
+	   if (i == 0)
+		  this->root = top;
+	   else
+		  link(path[i - 1], wentRight[i - 1], top);
+	   break;
+    }
+    return added;
+}
+
+// ##########################################################
+// @par Name
+// reserve
+// @purpose
+// makes room for n nodes so the arrays do not regrow while
+// inserting
+// @param [in] :
+// size_t n - number of nodes to make room for
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+void CompactAVLTree<T>::reserve(size_t n)
+{
+    this->nodes.reserve(n);
+    this->keys.reserve(n);
+}
+
+// ##########################################################
+// @par Name
+// shrinkToFit
+// @purpose
+// gives back the spare room the arrays grew into
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the arrays double as they grow, so up to half of them can be
+// unused once the input is read
+//###########################################################
+template<class T>
+void CompactAVLTree<T>::shrinkToFit()
+{
+    this->nodes.shrink_to_fit();
+    this->keys.shrinkToFit();
+}
+
+// ##########################################################
+// @par Name
+// printTree
+// @purpose
+// public access to display the data of the tree
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// same pre-order as AVLTree, so both trees print alike for
+// the same inserts
+//###########################################################
+template<class T>
+void CompactAVLTree<T>::printTree() const
+{
+    printTree(this->root);
+}
+
+// ##########################################################
+// @par Name
+// makeEmpty
+// @purpose
+// deletes every node of the tree
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the arrays give their memory back
+//###########################################################
+template<class T>
+void CompactAVLTree<T>::makeEmpty()
+{
+    std::vector<Node>().swap(this->nodes);
+    this->keys.clear();
+    this->overflow.clear();
+    this->root = COMPACT_NIL;
+}
+
+// ##########################################################
+// @par Name
+// memoryUsage
+// @purpose
+// estimates the bytes held by the tree
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+size_t CompactAVLTree<T>::memoryUsage() const
+{
+    return this->nodes.capacity() * sizeof(Node) + this->keys.memoryUsage();
+}
+
+// ##########################################################
+// @par Name
+// find
+// @purpose
+// finds the node holding data
+// @param [in] :
+// const T &data - data to be searched for
+// @return
+// uint32_t - index of the node, COMPACT_NIL if not found
+// @par References
+// None
+// @par Notes
+// the index is the one insert returned for data, so callers
+// may key their own per word data by it
+//###########################################################
+template<class T>
+uint32_t CompactAVLTree<T>::find(const T &data) const
+{
+    uint64_t prefix = keyPrefix(data);
+    uint32_t n = this->root;
+    while (n != COMPACT_NIL)
+    {
+	   int order = compare(data, prefix, n);
+	   if (order == 0)
+		  return n;
+	   n = order < 0 ? this->nodes[n].left : this->nodes[n].right;
+    }
+    return COMPACT_NIL;
+}
+
+// ##########################################################
+// @par Name
+// addCount
+// @purpose
+// adds occurrences to the word held by a node
+// @param [in] :
+// uint32_t n - index of the node
+// uint64_t count - number of occurrences to add
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the node keeps the count up to the largest uint32_t and the
+// rest goes to the overflow table, as AVLTree does with
+// PromoteCount
+//###########################################################
+template<class T>
+void CompactAVLTree<T>::addCount(uint32_t n, uint64_t count)
+{
+    const uint32_t limit = std::numeric_limits<uint32_t>::max();
+    Node &node = this->nodes[n];
+    if (count <= static_cast<uint64_t>(limit - node.wordCount))
+    {
+	   node.wordCount = static_cast<uint32_t>(node.wordCount + count);
+	   return;
+    }
+
+    count -= limit - node.wordCount;
+    node.wordCount = limit;
+    this->overflow[n] += count;
+}
+
+// ##########################################################
+// @par Name
+// countOf
+// @purpose
+// gets the number of occurrences of the word held by a node
+// @param [in] :
+// uint32_t n - index of the node
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// only a count at the largest uint32_t looks in the overflow
+// table
+//###########################################################
+template<class T>
+uint64_t CompactAVLTree<T>::countOf(uint32_t n) const
+{
+    uint32_t count = this->nodes[n].wordCount;
+    if (count == std::numeric_limits<uint32_t>::max() && !this->overflow.empty())
+    {
+	   auto extra = this->overflow.find(n);
+	   if (extra != this->overflow.end())
+		  return count + extra->second;
+    }
+    return count;
+}
+
+// ##########################################################
+// @par Name
+// compare
+// @purpose
+// orders data against the key of a node
+// @param [in] :
+// const T &data - data being searched for
+// uint64_t prefix - keyPrefix of data
+// uint32_t n - index of node to compare against
+// @return
+// int - negative if data goes left, 0 if it matches, positive
+//	   if it goes right
+// @par References
+// None
+// @par Notes
+// the key array is only read when the prefixes tie
+//###########################################################
+template<class T>
+int CompactAVLTree<T>::compare(const T &data, uint64_t prefix, uint32_t n) const
+{
+    uint64_t nodePrefix = this->nodes[n].prefix;
+    if (prefix != nodePrefix)
+	   return prefix < nodePrefix ? -1 : 1;
+    return this->keys.compare(data, n);
+}
+
+// ##########################################################
+// @par Name
+// printTree
+// @purpose
+// displays the data below a node to the console
+// @param [in] :
+// uint32_t n - index of node to display from
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+void CompactAVLTree<T>::printTree(uint32_t n) const
+{
+    if (n != COMPACT_NIL)
+    {
+	   cout << this->keys.at(n) << " - " << countOf(n) << endl;
+	   printTree(this->nodes[n].left);
+	   printTree(this->nodes[n].right);
+    }
+}
+
+// ##########################################################
+// @par Name
+// link
+// @purpose
+// makes a node the left or right child of its parent
+// @param [in] :
+// uint32_t parent - index of parent node
+// bool right - true to set the right child
+// uint32_t child - index of the new child
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+void CompactAVLTree<T>::link(uint32_t parent, bool right, uint32_t child)
+{
+    if (right)
+	   this->nodes[parent].right = child;
+    else
+	   this->nodes[parent].left = child;
+}
+
+// ##########################################################
+// @par Name
+// rotateLeft
+// @purpose
+// rotates a node with its right child
+// @param [in] :
+// uint32_t n - index of node to rotate
+// @return
+// uint32_t - index of the new subtree root
+// @par References
+// None
+// @par Notes
+// balance factors are left to the caller
+//###########################################################
+template<class T>
+uint32_t CompactAVLTree<T>::rotateLeft(uint32_t n)
+{
+    uint32_t p = this->nodes[n].right;
+    this->nodes[n].right = this->nodes[p].left;
+    this->nodes[p].left = n;
+    return p;
+}
+
+// ##########################################################
+// @par Name
+// rotateRight
+// @purpose
+// rotates a node with its left child
+// @param [in] :
+// uint32_t n - index of node to rotate
+// @return
+// uint32_t - index of the new subtree root
+// @par References
+// None
+// @par Notes
+// balance factors are left to the caller
+//###########################################################
+template<class T>
+uint32_t CompactAVLTree<T>::rotateRight(uint32_t n)
+{
+    uint32_t p = this->nodes[n].left;
+    this->nodes[n].left = this->nodes[p].right;
+    this->nodes[p].right = n;
+    return p;
+}
+
+// ##########################################################
+// @par Name
+// rebalance
+// @purpose
+// restores the balance of a node that is two levels heavier
+// on one side after an insert
+// @param [in] :
+// uint32_t n - index of the unbalanced node
+// @return
+// uint32_t - index of the new subtree root
+// @par References
+// None
+// @par Notes
+// balance is height(right) - height(left). A single rotation
+// fixes an outside insert and a double rotation an inside
+// one; the middle node's old balance decides the new balance
+// of the other two
+//###########################################################
+template<class T>
+uint32_t CompactAVLTree<T>::rebalance(uint32_t n)
+{
+    uint32_t top;
+    if (this->nodes[n].balance > 0)
+    {
+	   uint32_t z = this->nodes[n].right;
+	   if (this->nodes[z].balance > 0)
+	   {
+		  top = rotateLeft(n);
+		  this->nodes[n].balance = 0;
+		  this->nodes[z].balance = 0;
+	   }
+	   else
+	   {
+		  top = this->nodes[z].left;
+		  int8_t b = this->nodes[top].balance;
+		  this->nodes[n].right = rotateRight(z);
+		  rotateLeft(n);
+		  this->nodes[n].balance = b > 0 ? -1 : 0;
+		  this->nodes[z].balance = b < 0 ? 1 : 0;
+		  this->nodes[top].balance = 0;
+	   }
+    }
+    else
+    {
+	   uint32_t z = this->nodes[n].left;
+	   if (this->nodes[z].balance < 0)
+	   {
+		  top = rotateRight(n);
+		  this->nodes[n].balance = 0;
+		  this->nodes[z].balance = 0;
+	   }
+	   else
+	   {
+		  top = this->nodes[z].right;
+		  int8_t b = this->nodes[top].balance;
+		  this->nodes[n].left = rotateLeft(z);
+		  rotateRight(n);
+		  this->nodes[n].balance = b < 0 ? 1 : 0;
+		  this->nodes[z].balance = b > 0 ? -1 : 0;
+		  this->nodes[top].balance = 0;
+	   }
+    }
+    return top;
+}
+
+// ##########################################################
+// @par Name
+// forEach
+// @purpose
+// calls the visitor on every key and its count in sorted order
+// @param [in] :
+// Visitor visitor - callable taking (key, uint64_t count)
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// string keys are passed as a std::string_view into the key
+// array
+//###########################################################
+template<class T>
+template<class Visitor>
+void CompactAVLTree<T>::forEach(Visitor visitor) const
+{
+    forEachIndexed([&visitor](const auto &key, uint64_t count, uint32_t) { visitor(key, count); });
+}
+
+// ##########################################################
+// @par Name
+// forEachIndexed
+// @purpose
+// calls the visitor on every key, its count and its node index
+// in sorted order
+// @param [in] :
+// Visitor visitor - callable taking (key, uint64_t count,
+//				 uint32_t index)
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the index is the one insert returned for the key
+//###########################################################
+template<class T>
+template<class Visitor>
+void CompactAVLTree<T>::forEachIndexed(Visitor visitor) const
+{
+    uint32_t stack[COMPACT_MAX_HEIGHT];
+    int depth = 0;
+    uint32_t n = this->root;
+    while (n != COMPACT_NIL || depth > 0)
+    {
+	   while (n != COMPACT_NIL)
+	   {
+		  stack[depth++] = n;
+		  n = this->nodes[n].left;
+	   }
+	   n = stack[--depth];
+	   visitor(this->keys.at(n), countOf(n), n);
+	   n = this->nodes[n].right;
+    }
+}
+
+#endif
@@ -0,0 +1,392 @@
+//##########################################################
+// File: CountFile.cpp
+// Description: This file contains the class implementations
+//			 for CountFileWriter and CountFileReader
+//##########################################################
+
+#include "CountFile.h"
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <queue>
+
+// identifies a count file and its layout
+const char COUNT_FILE_MAGIC[4] = {'W', 'C', 'N', 'T'};
+const unsigned char COUNT_FILE_VERSION = 1;
+
+// words longer than this are treated as a corrupt file
+const uint64_t COUNT_FILE_MAX_WORD = 1 << 24;
+
+// ##########################################################
+// @par Name
+// CountFileWriter
+// @purpose
+// creates or truncates a count file and writes its header
+// @param [in] :
+// const string &path - name of file to write
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// check isOpen before writing
+//###########################################################
+CountFileWriter::CountFileWriter(const string &path) : file(nullptr), buffer(COUNT_FILE_BUFFER), error(false)
+{
+    this->file = std::fopen(path.c_str(), "wb");
+    if (this->file == nullptr)
+	   return;
+    std::setvbuf(this->file, this->buffer.data(), _IOFBF, this->buffer.size());
+    std::fwrite(COUNT_FILE_MAGIC, 1, sizeof(COUNT_FILE_MAGIC), this->file);
+    std::fputc(COUNT_FILE_VERSION, this->file);
+}
+
+// ##########################################################
+// @par Name
+// isOpen
+// @purpose
+// determines if the file was created
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool CountFileWriter::isOpen() const
+{
+    return this->file != nullptr;
+}
+
+// ##########################################################
+// @par Name
+// write
+// @purpose
+// appends one record to the file
+// @param [in] :
+// const string &word - word of the record
+// uint64_t count - number of times the word appeared
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// errors are reported by close
+//###########################################################
+void CountFileWriter::write(const string &word, uint64_t count)
+{
+    if (this->file == nullptr)
+	   return;
+    putVarint(word.size());
+    std::fwrite(word.data(), 1, word.size(), this->file);
+    putVarint(count);
+}
+
+// ##########################################################
+// @par Name
+// close
+// @purpose
+// flushes and closes the file
+// @param [in] :
+// None
+// @return
+// bool - true if every record reached the file
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool CountFileWriter::close()
+{
+    if (this->file == nullptr)
+	   return false;
+    if (std::ferror(this->file))
+	   this->error = true;
+    if (std::fclose(this->file) != 0)
+	   this->error = true;
+    this->file = nullptr;
+    return !this->error;
+}
+
+// ##########################################################
+// @par Name
+// ~CountFileWriter
+// @purpose
+// destructor
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+CountFileWriter::~CountFileWriter()
+{
+    if (this->file != nullptr)
+	   close();
+}
+
+// ##########################################################
+// @par Name
+// putVarint
+// @purpose
+// writes an unsigned integer 7 bits at a time
+// @param [in] :
+// uint64_t value - integer to write
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the high bit of each byte marks that another byte follows
+//###########################################################
+void CountFileWriter::putVarint(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+	   putc_unlocked(static_cast<int>((value & 0x7F) | 0x80), this->file);
+	   value >>= 7;
+    }
+    putc_unlocked(static_cast<int>(value), this->file);
+}
+
+// ##########################################################
+// @par Name
+// CountFileReader
+// @purpose
+// opens a count file and checks its header
+// @param [in] :
+// const string &path - name of file to read
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// a file with the wrong header is not opened
+//###########################################################
+CountFileReader::CountFileReader(const string &path) : file(nullptr), buffer(COUNT_FILE_BUFFER), error(false)
+{
+    this->file = std::fopen(path.c_str(), "rb");
+    if (this->file == nullptr)
+	   return;
+    std::setvbuf(this->file, this->buffer.data(), _IOFBF, this->buffer.size());
+
+    char magic[sizeof(COUNT_FILE_MAGIC)];
+    if (std::fread(magic, 1, sizeof(magic), this->file) != sizeof(magic) ||
+	   std::memcmp(magic, COUNT_FILE_MAGIC, sizeof(magic)) != 0 ||
+	   std::fgetc(this->file) != COUNT_FILE_VERSION)
+    {
+	   std::fclose(this->file);
+	   this->file = nullptr;
+    }
+}
+
+// ##########################################################
+// @par Name
+// isOpen
+// @purpose
+// determines if the file was opened and has a valid header
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool CountFileReader::isOpen() const
+{
+    return this->file != nullptr;
+}
+
+// ##########################################################
+// @par Name
+// next
+// @purpose
+// reads the next record of the file
+// @param [in] :
+// None
+// @return
+// bool - false at the end of the file or on a bad record
+// @par References
+// string &word - gets the word of the record
+// uint64_t &count - gets the count of the record
+// @par Notes
+// failed tells a bad record apart from the end of the file
+//###########################################################
+bool CountFileReader::next(string &word, uint64_t &count)
+{
+    if (this->file == nullptr || this->error)
+	   return false;
+
+    int first = getc_unlocked(this->file);
+    if (first == EOF)
+    {
+	   this->error = std::ferror(this->file) != 0;
+	   return false;
+    }
+    std::ungetc(first, this->file);
+
+    uint64_t length;
+    if (!getVarint(length) || length > COUNT_FILE_MAX_WORD)
+    {
+	   this->error = true;
+	   return false;
+    }
+    word.resize(length);
+    if (std::fread(&word[0], 1, length, this->file) != length || !getVarint(count))
+    {
+	   this->error = true;
+	   return false;
+    }
+    return true;
+}
+
+// ##########################################################
+// @par Name
+// failed
+// @purpose
+// determines if reading stopped on a bad or truncated record
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool CountFileReader::failed() const
+{
+    return this->error;
+}
+
+// ##########################################################
+// @par Name
+// ~CountFileReader
+// @purpose
+// destructor
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+CountFileReader::~CountFileReader()
+{
+    if (this->file != nullptr)
+	   std::fclose(this->file);
+}
+
+// ##########################################################
+// @par Name
+// getVarint
+// @purpose
+// reads an unsigned integer written by putVarint
+// @param [in] :
+// None
+// @return
+// bool - false if the file ends inside the integer
+// @par References
+// uint64_t &value - gets the integer
+// @par Notes
+// None
+//###########################################################
+bool CountFileReader::getVarint(uint64_t &value)
+{
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+	   int byte = getc_unlocked(this->file);
+	   if (byte == EOF)
+		  return false;
+	   value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+	   if ((byte & 0x80) == 0)
+		  return true;
+    }
+    return false;
+}
+
+// ##########################################################
+// @par Name
+// mergeCountFiles
+// @purpose
+// merges sorted count files into one sorted count file,
+// adding up the counts of words found in several inputs
+// @param [in] :
+// const std::vector<string> &inputs - sorted count files
+// const string &output - name of the merged file
+// @return
+// bool - false if an input could not be read or the output
+//	    could not be written
+// @par References
+// None
+// @par Notes
+// a k-way merge through a min-heap holding the current record
+// of each input, so memory is one record and one stdio buffer
+// per input however large the files are
+//###########################################################
+bool mergeCountFiles(const std::vector<string> &inputs, const string &output)
+{
+    struct Head
+    {
+	   string word;
+	   uint64_t count;
+	   size_t source;
+    };
+    auto later = [](const Head &a, const Head &b) { return a.word > b.word; };
+    std::priority_queue<Head, std::vector<Head>, decltype(later)> heads(later);
+
+    std::vector<std::unique_ptr<CountFileReader>> readers;
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+	   readers.emplace_back(new CountFileReader(inputs[i]));
+	   if (!readers.back()->isOpen())
+		  return false;
+	   Head head{string(), 0, i};
+	   if (readers.back()->next(head.word, head.count))
+		  heads.push(std::move(head));
+    }
+
+    CountFileWriter writer(output);
+    if (!writer.isOpen())
+	   return false;
+
+    string word;
+    uint64_t count = 0;
+    bool hasWord = false;
+    while (!heads.empty())
+    {
+	   Head head = heads.top();
+	   heads.pop();
+	   if (hasWord && head.word == word)
+		  count += head.count;
+	   else
+	   {
+		  if (hasWord)
+			 writer.write(word, count);
+		  word.swap(head.word);
+		  count = head.count;
+		  hasWord = true;
+	   }
+
+	   Head following{string(), 0, head.source};
+	   if (readers[head.source]->next(following.word, following.count))
+		  heads.push(std::move(following));
+    }
+    if (hasWord)
+	   writer.write(word, count);
+
+    for (const std::unique_ptr<CountFileReader> &reader : readers)
+	   if (reader->failed())
+		  return false;
+    return writer.close();
+}
@@ -0,0 +1,71 @@
+//##########################################################
+// File: CountFile.h
+// Description: This file contains the class definitions for
+//			 CountFileWriter and CountFileReader, which
+//			 store (word, count) records in a compact
+//			 binary file
+//##########################################################
+
+#ifndef COUNT_FILE_H
+#define COUNT_FILE_H
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using std::string;
+
+// bytes buffered by the stdio stream of a count file
+const size_t COUNT_FILE_BUFFER = 1 << 16;
+
+// a count file starts with "WCNT" and a version byte, followed
+// by records of varint(word length), word bytes, varint(count)
+// until the end of the file. Writers of sorted runs must add
+// records in increasing word order
+
+class CountFileWriter
+{
+private:
+    FILE *file;
+    std::vector<char> buffer;
+    bool error;
+
+    void putVarint(uint64_t value);
+
+public:
+    explicit CountFileWriter(const string &path);
+    CountFileWriter(const CountFileWriter &other) = delete;
+    CountFileWriter &operator=(const CountFileWriter &other) = delete;
+
+    bool isOpen() const;
+    void write(const string &word, uint64_t count);
+    bool close();
+
+    ~CountFileWriter();
+};
+
+class CountFileReader
+{
+private:
+    FILE *file;
+    std::vector<char> buffer;
+    bool error;
+
+    bool getVarint(uint64_t &value);
+
+public:
+    explicit CountFileReader(const string &path);
+    CountFileReader(const CountFileReader &other) = delete;
+    CountFileReader &operator=(const CountFileReader &other) = delete;
+
+    bool isOpen() const;
+    bool next(string &word, uint64_t &count);
+    bool failed() const;
+
+    ~CountFileReader();
+};
+
+bool mergeCountFiles(const std::vector<string> &inputs, const string &output);
+
+#endif
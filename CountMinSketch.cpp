@@ -0,0 +1,243 @@
+//##########################################################
+// File: CountMinSketch.cpp
+// Description: This file contains the class implementation
+//			 for CountMinSketch
+//##########################################################
+
+#include "CountMinSketch.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+// ##########################################################
+// @par Name
+// CountMinSketch
+// @purpose
+// creates a sketch sized for the requested error bounds
+// @param [in] :
+// double epsilon - overestimate allowed as a fraction of the
+//			 total count
+// double delta - probability the overestimate is exceeded
+// @return
+// None
+// @par References
+// Cormode and Muthukrishnan, An improved data stream summary:
+// the count-min sketch and its applications
+// @par Notes
+// the width is rounded up to a power of two so a row index is
+// a mask instead of a division. epsilon must be at least
+// minEpsilon and delta must be in (0, 1); callers check user
+// input first
+//###########################################################
+CountMinSketch::CountMinSketch(double epsilon, double delta) : width(1), depth(1), total(0)
+{
+    assert(epsilon >= minEpsilon() && delta > 0 && delta < 1);
+    double wantWidth = std::ceil(std::exp(1.0) / epsilon);
+    while (static_cast<double>(this->width) < wantWidth && this->width < SKETCH_MAX_WIDTH)
+	   this->width <<= 1;
+    this->depth = static_cast<size_t>(std::ceil(std::log(1.0 / delta)));
+    if (this->depth < 1)
+	   this->depth = 1;
+    this->table.assign(this->width * this->depth, 0);
+}
+
+// ##########################################################
+// @par Name
+// minEpsilon
+// @purpose
+// gets the smallest epsilon a sketch can be built for
+// @param [in] :
+// None
+// @return
+// double
+// @par References
+// None
+// @par Notes
+// below it a row would be wider than SKETCH_MAX_WIDTH
+//###########################################################
+double CountMinSketch::minEpsilon()
+{
+    return std::exp(1.0) / static_cast<double>(SKETCH_MAX_WIDTH);
+}
+
+// ##########################################################
+// @par Name
+// add
+// @purpose
+// records count occurrences of a hashed word
+// @param [in] :
+// uint64_t hash - 64 bit hash of the word
+// uint32_t count - number of occurrences to add
+// @return
+// None
+// @par References
+// Estan and Varghese, New directions in traffic measurement
+// and accounting (conservative update)
+// @par Notes
+// row i uses the hash h1 + i * h2, and only the counters at
+// the current minimum are raised, which keeps the same bound
+// with a smaller overestimate
+//###########################################################
+void CountMinSketch::add(uint64_t hash, uint32_t count)
+{
+    uint64_t h1 = hash;
+    uint64_t h2 = (hash >> 32) | (hash << 32) | 1;
+    size_t mask = this->width - 1;
+
+    uint32_t current = std::numeric_limits<uint32_t>::max();
+    for (size_t i = 0; i < this->depth; i++)
+	   current = std::min(current, this->table[i * this->width + ((h1 + i * h2) & mask)]);
+
+    uint64_t raised = uint64_t(current) + count;
+    uint32_t target = raised > std::numeric_limits<uint32_t>::max() ? std::numeric_limits<uint32_t>::max() : static_cast<uint32_t>(raised);
+    for (size_t i = 0; i < this->depth; i++)
+    {
+	   uint32_t &cell = this->table[i * this->width + ((h1 + i * h2) & mask)];
+	   if (cell < target)
+		  cell = target;
+    }
+    this->total += count;
+}
+
+// ##########################################################
+// @par Name
+// estimate
+// @purpose
+// estimates how many times a hashed word was added
+// @param [in] :
+// uint64_t hash - 64 bit hash of the word
+// @return
+// uint64_t - never below the true count
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t CountMinSketch::estimate(uint64_t hash) const
+{
+    uint64_t h1 = hash;
+    uint64_t h2 = (hash >> 32) | (hash << 32) | 1;
+    size_t mask = this->width - 1;
+
+    uint32_t result = std::numeric_limits<uint32_t>::max();
+    for (size_t i = 0; i < this->depth; i++)
+	   result = std::min(result, this->table[i * this->width + ((h1 + i * h2) & mask)]);
+    return result;
+}
+
+// ##########################################################
+// @par Name
+// epsilon
+// @purpose
+// gets the overestimate bound as a fraction of the total
+// @param [in] :
+// None
+// @return
+// double
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+double CountMinSketch::epsilon() const
+{
+    return std::exp(1.0) / static_cast<double>(this->width);
+}
+
+// ##########################################################
+// @par Name
+// delta
+// @purpose
+// gets the probability that an estimate exceeds its bound
+// @param [in] :
+// None
+// @return
+// double
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+double CountMinSketch::delta() const
+{
+    return std::exp(-static_cast<double>(this->depth));
+}
+
+// ##########################################################
+// @par Name
+// errorBound
+// @purpose
+// gets the most any estimate exceeds its true count, with
+// probability 1 - delta
+// @param [in] :
+// None
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t CountMinSketch::errorBound() const
+{
+    return static_cast<uint64_t>(std::ceil(epsilon() * static_cast<double>(this->total)));
+}
+
+// ##########################################################
+// @par Name
+// totalCount
+// @purpose
+// gets the number of occurrences added
+// @param [in] :
+// None
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t CountMinSketch::totalCount() const
+{
+    return this->total;
+}
+
+// ##########################################################
+// @par Name
+// memoryUsage
+// @purpose
+// gets the bytes held by the counters
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t CountMinSketch::memoryUsage() const
+{
+    return this->table.size() * sizeof(uint32_t);
+}
+
+// ##########################################################
+// @par Name
+// clear
+// @purpose
+// forgets every word added
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void CountMinSketch::clear()
+{
+    std::fill(this->table.begin(), this->table.end(), 0);
+    this->total = 0;
+}
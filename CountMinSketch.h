@@ -0,0 +1,44 @@
+//##########################################################
+// File: CountMinSketch.h
+// Description: This file contains the class definition for
+//			 CountMinSketch, a fixed size estimator of how
+//			 often each word appears
+//##########################################################
+
+#ifndef COUNT_MIN_SKETCH_H
+#define COUNT_MIN_SKETCH_H
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+using std::vector;
+
+// widest row a sketch is built with, 64MiB of counters per row;
+// it sets the smallest epsilon that can be asked for
+const size_t SKETCH_MAX_WIDTH = size_t(1) << 24;
+
+class CountMinSketch
+{
+private:
+    size_t width;
+    size_t depth;
+    uint64_t total;
+    vector<uint32_t> table;
+
+public:
+    CountMinSketch(double epsilon = 0.0001, double delta = 0.01);
+
+    static double minEpsilon();
+
+    void add(uint64_t hash, uint32_t count = 1);
+    uint64_t estimate(uint64_t hash) const;
+
+    double epsilon() const;
+    double delta() const;
+    uint64_t errorBound() const;
+    uint64_t totalCount() const;
+    size_t memoryUsage() const;
+    void clear();
+};
+
+#endif
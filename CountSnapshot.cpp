@@ -0,0 +1,368 @@
+//##########################################################
+// File: CountSnapshot.cpp
+// Description: This file contains the class implementation
+//			 for CountSnapshot
+//##########################################################
+
+#include "CountSnapshot.h"
+#include "CountFile.h"
+#include "ParallelSort.h"
+#include <algorithm>
+
+// ##########################################################
+// @par Name
+// CountSnapshot
+// @purpose
+// creates an empty snapshot
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+CountSnapshot::CountSnapshot() : offsets(1, 0), indexed(false), total(0), sorted(true) {}
+
+// ##########################################################
+// @par Name
+// add
+// @purpose
+// appends a word and its count
+// @param [in] :
+// std::string_view word - word to be added
+// uint64_t count - number of times the word appeared
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// words are expected in sorted order; finish sorts them and
+// adds up duplicates when they are not
+//###########################################################
+void CountSnapshot::add(std::string_view word, uint64_t count)
+{
+    if (!this->counts.empty() && word <= this->word(this->counts.size() - 1))
+	   this->sorted = false;
+    this->bytes.insert(this->bytes.end(), word.begin(), word.end());
+    this->offsets.push_back(this->bytes.size());
+    this->counts.push_back(count);
+    this->total += count;
+}
+
+// ##########################################################
+// @par Name
+// addPositions
+// @purpose
+// attaches postings to the word added last
+// @param [in] :
+// const PositionIndex &from - index holding the postings
+// uint32_t id - id of the word in from
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// called right after add, for every word or for none. The
+// postings are dropped if finish has to sort the words
+//###########################################################
+void CountSnapshot::addPositions(const PositionIndex &from, uint32_t id)
+{
+    if (!this->indexed)
+    {
+	   this->positions = PositionIndex(from.positionMode());
+	   this->indexed = true;
+    }
+    this->positions.append(from, id);
+}
+
+// ##########################################################
+// @par Name
+// finish
+// @purpose
+// prepares the snapshot for queries once every word is added
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// also ranks the words by count so top-K queries only read
+// the front of that order. Equal counts keep alphabetical
+// order. Both sorts run on every core
+//###########################################################
+void CountSnapshot::finish()
+{
+    if (!this->sorted)
+    {
+	   std::vector<uint32_t> order(this->counts.size());
+	   for (size_t i = 0; i < order.size(); i++)
+		  order[i] = static_cast<uint32_t>(i);
+	   parallelStableSort(order, [this](uint32_t a, uint32_t b) { return word(a) < word(b); });
+
+	   CountSnapshot rebuilt;
+	   for (uint32_t i : order)
+	   {
+		  size_t last = rebuilt.counts.size();
+		  if (last > 0 && rebuilt.word(last - 1) == word(i))
+		  {
+			 rebuilt.counts[last - 1] += this->counts[i];
+			 rebuilt.total += this->counts[i];
+		  }
+		  else
+			 rebuilt.add(word(i), this->counts[i]);
+	   }
+	   *this = std::move(rebuilt);
+    }
+
+    // the counts are copied next to the indices so the sort
+    // does not chase indices into counts
+    std::vector<std::pair<uint64_t, uint32_t>> ranks(this->counts.size());
+    for (size_t i = 0; i < ranks.size(); i++)
+	   ranks[i] = {this->counts[i], static_cast<uint32_t>(i)};
+    parallelStableSort(ranks, [](const std::pair<uint64_t, uint32_t> &a, const std::pair<uint64_t, uint32_t> &b)
+    {
+	   return a.first > b.first;
+    });
+    this->byCount.resize(ranks.size());
+    for (size_t i = 0; i < ranks.size(); i++)
+	   this->byCount[i] = ranks[i].second;
+}
+
+// ##########################################################
+// @par Name
+// load
+// @purpose
+// replaces the snapshot with the records of a count file
+// @param [in] :
+// const string &path - name of count file to read
+// @return
+// bool - false if the file could not be read completely
+// @par References
+// None
+// @par Notes
+// finish is called for you
+//###########################################################
+bool CountSnapshot::load(const string &path)
+{
+    *this = CountSnapshot();
+    CountFileReader file(path);
+    if (!file.isOpen())
+	   return false;
+
+    string word;
+    uint64_t count;
+    while (file.next(word, count))
+	   add(word, count);
+    finish();
+    return !file.failed();
+}
+
+// ##########################################################
+// @par Name
+// size
+// @purpose
+// gets the number of distinct words
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t CountSnapshot::size() const
+{
+    return this->counts.size();
+}
+
+// ##########################################################
+// @par Name
+// totalCount
+// @purpose
+// gets the number of words counted, repeats included
+// @param [in] :
+// None
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t CountSnapshot::totalCount() const
+{
+    return this->total;
+}
+
+// ##########################################################
+// @par Name
+// memoryUsage
+// @purpose
+// estimates the bytes held by the snapshot
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t CountSnapshot::memoryUsage() const
+{
+    return this->bytes.capacity() + this->offsets.capacity() * sizeof(uint64_t) +
+	      this->counts.capacity() * sizeof(uint64_t) + this->byCount.capacity() * sizeof(uint32_t) +
+	      this->positions.memoryUsage();
+}
+
+// ##########################################################
+// @par Name
+// word
+// @purpose
+// gets the word at a position in sorted order
+// @param [in] :
+// size_t i - position of the word
+// @return
+// std::string_view
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+std::string_view CountSnapshot::word(size_t i) const
+{
+    return std::string_view(this->bytes.data() + this->offsets[i], this->offsets[i + 1] - this->offsets[i]);
+}
+
+// ##########################################################
+// @par Name
+// countAt
+// @purpose
+// gets the count of the word at a position in sorted order
+// @param [in] :
+// size_t i - position of the word
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t CountSnapshot::countAt(size_t i) const
+{
+    return this->counts[i];
+}
+
+// ##########################################################
+// @par Name
+// lowerBound
+// @purpose
+// finds the first word that is not less than a key
+// @param [in] :
+// std::string_view key - key to search for
+// @return
+// size_t - position of the word, size() if there is none
+// @par References
+// None
+// @par Notes
+// binary search over the sorted words
+//###########################################################
+size_t CountSnapshot::lowerBound(std::string_view key) const
+{
+    size_t low = 0;
+    size_t high = size();
+    while (low < high)
+    {
+	   size_t mid = low + (high - low) / 2;
+	   if (word(mid) < key)
+		  low = mid + 1;
+	   else
+		  high = mid;
+    }
+    return low;
+}
+
+// ##########################################################
+// @par Name
+// count
+// @purpose
+// gets the number of times a word appeared
+// @param [in] :
+// std::string_view key - word to be searched for
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// 0 when the word is not in the snapshot
+//###########################################################
+uint64_t CountSnapshot::count(std::string_view key) const
+{
+    size_t i = lowerBound(key);
+    return i < size() && word(i) == key ? this->counts[i] : 0;
+}
+
+// ##########################################################
+// @par Name
+// hasPositions
+// @purpose
+// determines if the words came with their postings
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool CountSnapshot::hasPositions() const
+{
+    return this->indexed;
+}
+
+// ##########################################################
+// @par Name
+// positionMode
+// @purpose
+// gets what the postings record
+// @param [in] :
+// None
+// @return
+// PositionMode
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+PositionMode CountSnapshot::positionMode() const
+{
+    return this->positions.positionMode();
+}
+
+// ##########################################################
+// @par Name
+// positionsOf
+// @purpose
+// gets every recorded position of a word
+// @param [in] :
+// std::string_view key - word to be searched for
+// @return
+// std::vector<Posting> - positions in text order, empty when
+//					 the word or its postings are missing
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+std::vector<Posting> CountSnapshot::positionsOf(std::string_view key) const
+{
+    size_t i = lowerBound(key);
+    if (!this->indexed || i >= size() || word(i) != key)
+	   return std::vector<Posting>();
+    return this->positions.find(static_cast<uint32_t>(i));
+}
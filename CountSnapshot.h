@@ -0,0 +1,142 @@
+//##########################################################
+// File: CountSnapshot.h
+// Description: This file contains the class definition for
+//			 CountSnapshot, a read only sorted copy of the
+//			 word counts that answers queries
+//##########################################################
+
+#ifndef COUNT_SNAPSHOT_H
+#define COUNT_SNAPSHOT_H
+#include "PositionIndex.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using std::string;
+
+class CountSnapshot
+{
+private:
+    std::vector<char> bytes;
+    std::vector<uint64_t> offsets;
+    std::vector<uint64_t> counts;
+    std::vector<uint32_t> byCount;
+    // word i's postings are list i, when the words came with any
+    PositionIndex positions;
+    bool indexed;
+    uint64_t total;
+    bool sorted;
+
+public:
+    CountSnapshot();
+
+    void add(std::string_view word, uint64_t count);
+    void addPositions(const PositionIndex &from, uint32_t id);
+    void finish();
+    bool load(const string &path);
+
+    size_t size() const;
+    uint64_t totalCount() const;
+    size_t memoryUsage() const;
+
+    std::string_view word(size_t i) const;
+    uint64_t countAt(size_t i) const;
+    size_t lowerBound(std::string_view key) const;
+    uint64_t count(std::string_view key) const;
+    bool hasPositions() const;
+    PositionMode positionMode() const;
+    std::vector<Posting> positionsOf(std::string_view key) const;
+
+    template<class Visitor>
+    void topK(size_t k, Visitor visitor) const;
+    template<class Visitor>
+    void prefix(std::string_view key, size_t limit, Visitor visitor) const;
+    template<class Visitor>
+    void range(std::string_view low, std::string_view high, size_t limit, Visitor visitor) const;
+};
+
+// ##########################################################
+// @par Name
+// topK
+// @purpose
+// calls the visitor on the k most frequent words, most
+// frequent first
+// @param [in] :
+// size_t k - number of words wanted
+// Visitor visitor - callable taking (std::string_view, uint64_t)
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the order is computed once by finish, so this is O(k)
+//###########################################################
+template<class Visitor>
+void CountSnapshot::topK(size_t k, Visitor visitor) const
+{
+    for (size_t i = 0; i < k && i < this->byCount.size(); i++)
+	   visitor(word(this->byCount[i]), this->counts[this->byCount[i]]);
+}
+
+// ##########################################################
+// @par Name
+// prefix
+// @purpose
+// calls the visitor on the words starting with a prefix in
+// sorted order
+// @param [in] :
+// std::string_view key - prefix the words must start with
+// size_t limit - most words to visit
+// Visitor visitor - callable taking (std::string_view, uint64_t)
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class Visitor>
+void CountSnapshot::prefix(std::string_view key, size_t limit, Visitor visitor) const
+{
+    for (size_t i = lowerBound(key); i < size() && limit > 0; i++, limit--)
+    {
+	   std::string_view w = word(i);
+	   if (w.compare(0, key.size(), key) != 0)
+		  break;
+	   visitor(w, this->counts[i]);
+    }
+}
+
+// ##########################################################
+// @par Name
+// range
+// @purpose
+// calls the visitor on the words from low up to but not
+// including high in sorted order
+// @param [in] :
+// std::string_view low - first word of the range
+// std::string_view high - end of the range, empty for no end
+// size_t limit - most words to visit
+// Visitor visitor - callable taking (std::string_view, uint64_t)
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class Visitor>
+void CountSnapshot::range(std::string_view low, std::string_view high, size_t limit, Visitor visitor) const
+{
+    for (size_t i = lowerBound(low); i < size() && limit > 0; i++, limit--)
+    {
+	   std::string_view w = word(i);
+	   if (!high.empty() && w >= high)
+		  break;
+	   visitor(w, this->counts[i]);
+    }
+}
+
+#endif
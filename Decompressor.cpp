@@ -0,0 +1,373 @@
+//##########################################################
+// File: Decompressor.cpp
+// Description: This file contains the class implementation
+//			 for Decompressor
+//##########################################################
+
+#include "Decompressor.h"
+#ifdef WORDCOUNT_USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef WORDCOUNT_USE_ZSTD
+#include <zstd.h>
+#endif
+
+// codec state, only the members of compiled in codecs exist
+struct Decompressor::State
+{
+#ifdef WORDCOUNT_USE_ZLIB
+    z_stream zs{};
+    bool inMember = false;
+#endif
+#ifdef WORDCOUNT_USE_ZSTD
+    ZSTD_DCtx *dctx = nullptr;
+    ZSTD_inBuffer in{nullptr, 0, 0};
+    size_t lastResult = 0;
+#endif
+};
+
+// ##########################################################
+// @par Name
+// Decompressor
+// @purpose
+// creates a decompressor for one stream of the given format
+// @param [in] :
+// Compression fmt - format of the stream
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// gzip needs WORDCOUNT_USE_ZLIB (-lz) and zstd needs
+// WORDCOUNT_USE_ZSTD (-lzstd); check isSupported before use
+//###########################################################
+Decompressor::Decompressor(Compression fmt) : format(fmt), state(new State), inputEnded(false), done(false), error(false)
+{
+#ifdef WORDCOUNT_USE_ZLIB
+    if (this->format == GZIP && inflateInit2(&this->state->zs, 16 + MAX_WBITS) != Z_OK)
+	   this->error = true;
+#endif
+#ifdef WORDCOUNT_USE_ZSTD
+    if (this->format == ZSTD)
+    {
+	   this->state->dctx = ZSTD_createDCtx();
+	   if (this->state->dctx == nullptr)
+		  this->error = true;
+    }
+#endif
+    if (!isSupported())
+	   this->error = true;
+    if (this->error)
+	   this->done = true;
+}
+
+// ##########################################################
+// @par Name
+// ~Decompressor
+// @purpose
+// destructor
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+Decompressor::~Decompressor()
+{
+#ifdef WORDCOUNT_USE_ZLIB
+    if (this->format == GZIP)
+	   inflateEnd(&this->state->zs);
+#endif
+#ifdef WORDCOUNT_USE_ZSTD
+    if (this->state->dctx != nullptr)
+	   ZSTD_freeDCtx(this->state->dctx);
+#endif
+}
+
+// ##########################################################
+// @par Name
+// detect
+// @purpose
+// determines the format of a stream from its first bytes
+// @param [in] :
+// const unsigned char *magic - first bytes of the stream
+// size_t len - number of bytes available, up to 4 are used
+// @return
+// Compression
+// @par References
+// RFC 1952 and RFC 8878 magic numbers
+// @par Notes
+// None
+//###########################################################
+Compression Decompressor::detect(const unsigned char *magic, size_t len)
+{
+    if (len >= 2 && magic[0] == 0x1f && magic[1] == 0x8b)
+	   return GZIP;
+    if (len >= 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd)
+	   return ZSTD;
+    return NO_COMPRESSION;
+}
+
+// ##########################################################
+// @par Name
+// name
+// @purpose
+// gets a printable name for a format
+// @param [in] :
+// Compression fmt - format to name
+// @return
+// const char *
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+const char *Decompressor::name(Compression fmt)
+{
+    switch (fmt)
+    {
+    case GZIP:
+	   return "gzip";
+    case ZSTD:
+	   return "zstd";
+    default:
+	   return "plain";
+    }
+}
+
+// ##########################################################
+// @par Name
+// isSupported
+// @purpose
+// determines if the codec for this format was compiled in
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool Decompressor::isSupported() const
+{
+#ifdef WORDCOUNT_USE_ZLIB
+    if (this->format == GZIP)
+	   return true;
+#endif
+#ifdef WORDCOUNT_USE_ZSTD
+    if (this->format == ZSTD)
+	   return true;
+#endif
+    return false;
+}
+
+// ##########################################################
+// @par Name
+// needsInput
+// @purpose
+// determines if the last input has been used up
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool Decompressor::needsInput() const
+{
+    if (this->done || this->inputEnded)
+	   return false;
+#ifdef WORDCOUNT_USE_ZLIB
+    if (this->format == GZIP)
+	   return this->state->zs.avail_in == 0;
+#endif
+#ifdef WORDCOUNT_USE_ZSTD
+    if (this->format == ZSTD)
+	   return this->state->in.pos == this->state->in.size;
+#endif
+    return false;
+}
+
+// ##########################################################
+// @par Name
+// finished
+// @purpose
+// determines if every byte of the stream has been produced
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool Decompressor::finished() const
+{
+    return this->done;
+}
+
+// ##########################################################
+// @par Name
+// failed
+// @purpose
+// determines if the stream was corrupt, truncated or of an
+// unsupported format
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool Decompressor::failed() const
+{
+    return this->error;
+}
+
+// ##########################################################
+// @par Name
+// setInput
+// @purpose
+// hands the next compressed bytes to the decompressor
+// @param [in] :
+// const char *data - compressed bytes, kept until used up
+// size_t len - number of bytes, 0 at the end of the input
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void Decompressor::setInput(const char *data, size_t len)
+{
+    if (len == 0)
+    {
+	   this->inputEnded = true;
+	   return;
+    }
+#ifdef WORDCOUNT_USE_ZLIB
+    if (this->format == GZIP)
+    {
+	   this->state->zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+	   this->state->zs.avail_in = static_cast<uInt>(len);
+    }
+#endif
+#ifdef WORDCOUNT_USE_ZSTD
+    if (this->format == ZSTD)
+	   this->state->in = ZSTD_inBuffer{data, len, 0};
+#endif
+    (void)data;
+}
+
+// ##########################################################
+// @par Name
+// decompress
+// @purpose
+// produces as many decompressed bytes as the current input
+// allows
+// @param [in] :
+// char *dest - where the bytes are stored
+// size_t len - room in dest
+// @return
+// size_t - bytes produced
+// @par References
+// None
+// @par Notes
+// concatenated gzip members and zstd frames are decoded as one
+// stream; input ending inside a member or frame is an error,
+// which zstd reports as a nonzero hint from its last call
+//###########################################################
+size_t Decompressor::decompress(char *dest, size_t len)
+{
+    if (this->done)
+	   return 0;
+    size_t produced = 0;
+
+#ifdef WORDCOUNT_USE_ZLIB
+    if (this->format == GZIP)
+    {
+	   z_stream &zs = this->state->zs;
+	   zs.next_out = reinterpret_cast<Bytef *>(dest);
+	   zs.avail_out = static_cast<uInt>(len);
+	   while (zs.avail_out > 0)
+	   {
+		  uInt outBefore = zs.avail_out;
+		  uInt inBefore = zs.avail_in;
+		  int ret = inflate(&zs, Z_NO_FLUSH);
+		  if (zs.avail_in != inBefore)
+			 this->state->inMember = true;
+
+		  if (ret == Z_STREAM_END)
+		  {
+			 inflateReset(&zs);
+			 this->state->inMember = false;
+		  }
+		  else if (ret == Z_BUF_ERROR || (ret == Z_OK && zs.avail_out == outBefore && zs.avail_in == inBefore))
+		  {
+			 // no progress without more input
+			 if (this->inputEnded)
+			 {
+				this->error = this->state->inMember;
+				this->done = true;
+			 }
+			 break;
+		  }
+		  else if (ret != Z_OK)
+		  {
+			 this->error = true;
+			 this->done = true;
+			 break;
+		  }
+	   }
+	   produced = len - zs.avail_out;
+    }
+#endif
+#ifdef WORDCOUNT_USE_ZSTD
+    if (this->format == ZSTD)
+    {
+	   ZSTD_outBuffer out{dest, len, 0};
+	   while (out.pos < out.size)
+	   {
+		  if (this->state->in.pos == this->state->in.size)
+		  {
+			 // a frame can still hold buffered output after its input is used
+			 size_t before = out.pos;
+			 size_t result = ZSTD_decompressStream(this->state->dctx, &out, &this->state->in);
+			 if (!ZSTD_isError(result) && out.pos != before)
+			 {
+				this->state->lastResult = result;
+				continue;
+			 }
+			 if (this->inputEnded)
+			 {
+				this->error = ZSTD_isError(this->state->lastResult) || this->state->lastResult != 0;
+				this->done = true;
+			 }
+			 break;
+		  }
+
+		  this->state->lastResult = ZSTD_decompressStream(this->state->dctx, &out, &this->state->in);
+		  if (ZSTD_isError(this->state->lastResult))
+		  {
+			 this->error = true;
+			 this->done = true;
+			 break;
+		  }
+	   }
+	   produced = out.pos;
+    }
+#endif
+    (void)dest;
+    (void)len;
+    return produced;
+}
@@ -0,0 +1,50 @@
+//##########################################################
+// File: Decompressor.h
+// Description: This file contains the class definition for
+//			 Decompressor, which expands gzip and zstd
+//			 streams block by block
+//##########################################################
+
+#ifndef DECOMPRESSOR_H
+#define DECOMPRESSOR_H
+#include <cstddef>
+#include <memory>
+
+enum Compression
+{
+    NO_COMPRESSION,
+    GZIP,
+    ZSTD
+};
+
+class Decompressor
+{
+private:
+    struct State;
+
+    Compression format;
+    std::unique_ptr<State> state;
+    bool inputEnded;
+    bool done;
+    bool error;
+
+public:
+    explicit Decompressor(Compression fmt);
+    Decompressor(const Decompressor &other) = delete;
+    Decompressor &operator=(const Decompressor &other) = delete;
+
+    static Compression detect(const unsigned char *magic, size_t len);
+    static const char *name(Compression fmt);
+
+    bool isSupported() const;
+    bool needsInput() const;
+    bool finished() const;
+    bool failed() const;
+
+    void setInput(const char *data, size_t len);
+    size_t decompress(char *dest, size_t len);
+
+    ~Decompressor();
+};
+
+#endif
@@ -0,0 +1,95 @@
+//##########################################################
+// File: Hash.h
+// Description: This file contains the hash functions shared
+//			 by the hashed counting structures
+//##########################################################
+
+#ifndef HASH_H
+#define HASH_H
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+// ##########################################################
+// @par Name
+// mixHash
+// @purpose
+// scrambles the bits of a 64 bit value
+// @param [in] :
+// uint64_t h - value to scramble
+// @return
+// uint64_t
+// @par References
+// MurmurHash3 fmix64 finalizer
+// @par Notes
+// None
+//###########################################################
+inline uint64_t mixHash(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// ##########################################################
+// @par Name
+// hashBytes
+// @purpose
+// hashes a run of bytes eight bytes at a time
+// @param [in] :
+// const char *data - bytes to hash
+// size_t len - number of bytes
+// uint64_t seed - value that selects the hash function
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// not cryptographic, only meant to spread words over tables
+//###########################################################
+inline uint64_t hashBytes(const char *data, size_t len, uint64_t seed = 0)
+{
+    const uint64_t k = 0x9e3779b97f4a7c15ULL;
+    uint64_t h = seed ^ (len * k);
+    while (len >= 8)
+    {
+	   uint64_t w;
+	   memcpy(&w, data, 8);
+	   h = (h ^ mixHash(w * k)) * k;
+	   data += 8;
+	   len -= 8;
+    }
+    if (len > 0)
+    {
+	   uint64_t w = 0;
+	   memcpy(&w, data, len);
+	   h = (h ^ mixHash(w * k)) * k;
+    }
+    return mixHash(h);
+}
+
+// ##########################################################
+// @par Name
+// hashWord
+// @purpose
+// hashes a word
+// @param [in] :
+// const std::string &word - word to hash
+// uint64_t seed - value that selects the hash function
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+inline uint64_t hashWord(const std::string &word, uint64_t seed = 0)
+{
+    return hashBytes(word.data(), word.size(), seed);
+}
+
+#endif
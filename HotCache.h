@@ -0,0 +1,295 @@
+//##########################################################
+// File: HotCache.h
+// Description: This file contains the HotCache template
+//			 class, a direct-mapped cache of the nodes
+//			 holding the most frequent words
+//##########################################################
+
+#ifndef HOT_CACHE_H
+#define HOT_CACHE_H
+#include "AVLTree.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// slots in the cache; a few hundred hot words cover most of
+// natural text and 1024 slots still fit in the L1/L2 cache
+const size_t HOT_CACHE_SLOTS = 1024;
+
+template<class T, class C = uint32_t>
+class HotCache
+{
+private:
+    struct Slot
+    {
+	   uint64_t hash;
+	   AVLNode<T, C> *node;
+	   uint32_t uses;
+    };
+
+    std::vector<Slot> slots;
+    size_t mask;
+    uint64_t generation;
+    uint64_t hits;
+    uint64_t misses;
+
+public:
+    explicit HotCache(size_t numSlots = HOT_CACHE_SLOTS);
+
+    AVLNode<T, C> *hit(const T &data, uint64_t hash);
+    void admit(uint64_t hash, AVLNode<T, C> *node, uint64_t count);
+    void sync(uint64_t treeGeneration);
+    void clear();
+    void resize(size_t numSlots);
+
+    uint64_t hitCount() const;
+    uint64_t missCount() const;
+    double hitRate() const;
+    size_t capacity() const;
+};
+
+// ##########################################################
+// @par Name
+// HotCache
+// @purpose
+// creates an empty cache
+// @param [in] :
+// size_t numSlots - number of slots, rounded up to a power
+//				 of two; 0 disables the cache
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T, class C>
+HotCache<T, C>::HotCache(size_t numSlots) : mask(0), generation(0), hits(0), misses(0)
+{
+    resize(numSlots);
+}
+
+// ##########################################################
+// @par Name
+// hit
+// @purpose
+// finds the tree node of a word when the node is cached
+// @param [in] :
+// const T &data - word read from the file
+// uint64_t hash - hash of the word
+// @return
+// AVLNode<T, C> * - node to count the word in through the
+//				 tree's addCount, or null on a miss
+// @par References
+// None
+// @par Notes
+// one hash compare and, on a match, one full compare; a miss
+// leaves the word to the normal insert path
+//###########################################################
+template<class T, class C>
+AVLNode<T, C> *HotCache<T, C>::hit(const T &data, uint64_t hash)
+{
+    if (this->slots.empty())
+	   return nullptr;
+
+    Slot &slot = this->slots[hash & this->mask];
+    if (slot.node != nullptr && slot.hash == hash && slot.node->element == data)
+    {
+	   slot.uses++;
+	   this->hits++;
+	   return slot.node;
+    }
+    this->misses++;
+    return nullptr;
+}
+
+// ##########################################################
+// @par Name
+// admit
+// @purpose
+// offers a freshly inserted node to the cache
+// @param [in] :
+// uint64_t hash - hash of the node's word
+// AVLNode<T, C> *node - node holding the word
+// uint64_t count - occurrences just added to the node
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// a node only replaces the current one when it was seen at
+// least as often; otherwise the current one's use count is
+// halved so a word that has gone cold is eventually evicted
+//###########################################################
+template<class T, class C>
+void HotCache<T, C>::admit(uint64_t hash, AVLNode<T, C> *node, uint64_t count)
+{
+    if (this->slots.empty())
+	   return;
+
+    Slot &slot = this->slots[hash & this->mask];
+    if (slot.node == node)
+	   slot.uses += static_cast<uint32_t>(count);
+    else if (slot.node == nullptr || static_cast<uint32_t>(count) >= slot.uses)
+	   slot = Slot{hash, node, static_cast<uint32_t>(count)};
+    else
+	   slot.uses >>= 1;
+}
+
+// ##########################################################
+// @par Name
+// sync
+// @purpose
+// drops every cached node if the tree has removed or moved
+// nodes since the cache was filled
+// @param [in] :
+// uint64_t treeGeneration - current generation of the tree
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T, class C>
+void HotCache<T, C>::sync(uint64_t treeGeneration)
+{
+    if (treeGeneration != this->generation)
+    {
+	   clear();
+	   this->generation = treeGeneration;
+    }
+}
+
+// ##########################################################
+// @par Name
+// clear
+// @purpose
+// forgets every cached node
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the hit statistics are kept
+//###########################################################
+template<class T, class C>
+void HotCache<T, C>::clear()
+{
+    for (Slot &slot : this->slots)
+	   slot = Slot{0, nullptr, 0};
+}
+
+// ##########################################################
+// @par Name
+// resize
+// @purpose
+// changes the number of slots and empties the cache
+// @param [in] :
+// size_t numSlots - number of slots, rounded up to a power
+//				 of two; 0 disables the cache
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T, class C>
+void HotCache<T, C>::resize(size_t numSlots)
+{
+    size_t size = 0;
+    if (numSlots > 0)
+    {
+	   size = 1;
+	   while (size < numSlots)
+		  size <<= 1;
+    }
+    this->slots.assign(size, Slot{0, nullptr, 0});
+    this->mask = size ? size - 1 : 0;
+}
+
+// ##########################################################
+// @par Name
+// hitCount
+// @purpose
+// gets the number of words counted through the cache
+// @param [in] :
+// None
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T, class C>
+uint64_t HotCache<T, C>::hitCount() const
+{
+    return this->hits;
+}
+
+// ##########################################################
+// @par Name
+// missCount
+// @purpose
+// gets the number of words that fell through to the tree
+// @param [in] :
+// None
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T, class C>
+uint64_t HotCache<T, C>::missCount() const
+{
+    return this->misses;
+}
+
+// ##########################################################
+// @par Name
+// hitRate
+// @purpose
+// gets the fraction of lookups answered by the cache
+// @param [in] :
+// None
+// @return
+// double
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T, class C>
+double HotCache<T, C>::hitRate() const
+{
+    uint64_t total = this->hits + this->misses;
+    return total ? static_cast<double>(this->hits) / total : 0.0;
+}
+
+// ##########################################################
+// @par Name
+// capacity
+// @purpose
+// gets the number of slots in the cache
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T, class C>
+size_t HotCache<T, C>::capacity() const
+{
+    return this->slots.size();
+}
+
+#endif
@@ -0,0 +1,140 @@
+//##########################################################
+// File: HyperLogLog.cpp
+// Description: This file contains the class implementation
+//			 for HyperLogLog
+//##########################################################
+
+#include "HyperLogLog.h"
+#include <algorithm>
+#include <cmath>
+
+// ##########################################################
+// @par Name
+// HyperLogLog
+// @purpose
+// creates an estimator with 2^p registers
+// @param [in] :
+// unsigned p - number of hash bits used to pick a register,
+//			 clamped to [4, 18]
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// memory is 2^p bytes and does not grow with the input
+//###########################################################
+HyperLogLog::HyperLogLog(unsigned p) : precision(p < 4 ? 4 : (p > 18 ? 18 : p)), registers(size_t(1) << precision, 0) {}
+
+// ##########################################################
+// @par Name
+// add
+// @purpose
+// records one hashed word
+// @param [in] :
+// uint64_t hash - 64 bit hash of the word
+// @return
+// None
+// @par References
+// Flajolet et al., HyperLogLog: the analysis of a near-optimal
+// cardinality estimation algorithm
+// @par Notes
+// the top p bits pick the register, the rest give the rank
+//###########################################################
+void HyperLogLog::add(uint64_t hash)
+{
+    size_t index = hash >> (64 - this->precision);
+    uint64_t rest = (hash << this->precision) | (uint64_t(1) << (this->precision - 1));
+    uint8_t rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    if (rank > this->registers[index])
+	   this->registers[index] = rank;
+}
+
+// ##########################################################
+// @par Name
+// estimate
+// @purpose
+// estimates the number of distinct words added
+// @param [in] :
+// None
+// @return
+// double
+// @par References
+// None
+// @par Notes
+// switches to linear counting while many registers are empty
+//###########################################################
+double HyperLogLog::estimate() const
+{
+    double m = static_cast<double>(this->registers.size());
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t r : this->registers)
+    {
+	   sum += std::ldexp(1.0, -r);
+	   if (r == 0)
+		  zeros++;
+    }
+
+    double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double e = alpha * m * m / sum;
+    if (e <= 2.5 * m && zeros != 0)
+	   e = m * std::log(m / static_cast<double>(zeros));
+    return e;
+}
+
+// ##########################################################
+// @par Name
+// relativeError
+// @purpose
+// gets the standard error of the estimate as a fraction
+// @param [in] :
+// None
+// @return
+// double
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+double HyperLogLog::relativeError() const
+{
+    return 1.04 / std::sqrt(static_cast<double>(this->registers.size()));
+}
+
+// ##########################################################
+// @par Name
+// memoryUsage
+// @purpose
+// gets the bytes held by the registers
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t HyperLogLog::memoryUsage() const
+{
+    return this->registers.size();
+}
+
+// ##########################################################
+// @par Name
+// clear
+// @purpose
+// forgets every word added
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void HyperLogLog::clear()
+{
+    std::fill(this->registers.begin(), this->registers.end(), 0);
+}
@@ -0,0 +1,32 @@
+//##########################################################
+// File: HyperLogLog.h
+// Description: This file contains the class definition for
+//			 HyperLogLog, a fixed size estimator of the
+//			 number of distinct words
+//##########################################################
+
+#ifndef HYPERLOGLOG_H
+#define HYPERLOGLOG_H
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+using std::vector;
+
+class HyperLogLog
+{
+private:
+    unsigned precision;
+    vector<uint8_t> registers;
+
+public:
+    explicit HyperLogLog(unsigned p = 14);
+
+    void add(uint64_t hash);
+    double estimate() const;
+    double relativeError() const;
+    size_t memoryUsage() const;
+    void clear();
+};
+
+#endif
@@ -0,0 +1,367 @@
+//##########################################################
+// File: NGramCount.cpp
+// Description: This file contains the class implementation
+//			 for NGramCount
+//##########################################################
+
+#include "NGramCount.h"
+#include "Hash.h"
+#include <algorithm>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+// ##########################################################
+// @par Name
+// operator()
+// @purpose
+// hashes a word for the intern table
+// @param [in] :
+// const string &word - word to hash
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t WordHash::operator()(const string &word) const
+{
+    return static_cast<size_t>(hashWord(word));
+}
+
+// ##########################################################
+// @par Name
+// NGramCount
+// @purpose
+// creates a counter for runs of size consecutive words
+// @param [in] :
+// unsigned size - words per n-gram, clamped to [1, MAX_NGRAM]
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+NGramCount::NGramCount(unsigned size) : n(size < 1 ? 1 : (size > MAX_NGRAM ? MAX_NGRAM : size)), seen(0), window(), table(1024), used(0) {}
+
+// ##########################################################
+// @par Name
+// add
+// @purpose
+// records the next word of the text and counts the n-gram
+// ending at it
+// @param [in] :
+// const string &word - next word of the text
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the window of the last n ids is shifted by one, so each
+// n-gram costs one intern lookup and one packed key probe
+//###########################################################
+void NGramCount::add(const string &word)
+{
+    uint32_t id = intern(word);
+    for (unsigned i = 0; i + 1 < this->n; i++)
+	   this->window[i] = this->window[i + 1];
+    this->window[this->n - 1] = id;
+
+    if (++this->seen >= this->n)
+	   increment(packKey(this->window), 1);
+}
+
+// ##########################################################
+// @par Name
+// reset
+// @purpose
+// starts a new run of text so no n-gram spans the boundary
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// counts and interned words are kept
+//###########################################################
+void NGramCount::reset()
+{
+    this->seen = 0;
+}
+
+// ##########################################################
+// @par Name
+// count
+// @purpose
+// gets how many times a phrase appeared
+// @param [in] :
+// const vector<string> &query - n words to be searched for
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t NGramCount::count(const vector<string> &query) const
+{
+    if (query.size() != this->n)
+	   return 0;
+
+    uint32_t phraseIds[MAX_NGRAM];
+    for (unsigned i = 0; i < this->n; i++)
+    {
+	   auto it = this->ids.find(query[i]);
+	   if (it == this->ids.end())
+		  return 0;
+	   phraseIds[i] = it->second;
+    }
+
+    const NGramEntry &e = this->table[findSlot(packKey(phraseIds))];
+    return e.wordCount;
+}
+
+// ##########################################################
+// @par Name
+// size
+// @purpose
+// gets the number of distinct n-grams
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t NGramCount::size() const
+{
+    return this->used;
+}
+
+// ##########################################################
+// @par Name
+// memoryUsage
+// @purpose
+// estimates the bytes held by the ids and the n-gram table
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// hash map node overhead is approximated by two pointers
+//###########################################################
+size_t NGramCount::memoryUsage() const
+{
+    size_t bytes = this->table.size() * sizeof(NGramEntry) + this->words.capacity() * sizeof(string);
+    for (const string &w : this->words)
+	   if (w.capacity() > string().capacity())
+		  bytes += w.capacity() + 1;
+    bytes += this->ids.size() * (sizeof(string) + sizeof(uint32_t) + 2 * sizeof(void *));
+    bytes += this->ids.bucket_count() * sizeof(void *);
+    return bytes;
+}
+
+// ##########################################################
+// @par Name
+// display
+// @purpose
+// displays the n-grams from most to least frequent
+// @param [in] :
+// size_t limit - most n-grams to display, 0 for all of them
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// ties are displayed alphabetically
+//###########################################################
+void NGramCount::display(size_t limit) const
+{
+    vector<std::pair<uint64_t, string>> sorted;
+    sorted.reserve(this->used);
+    for (const NGramEntry &e : this->table)
+	   if (e.wordCount != 0)
+		  sorted.push_back({e.wordCount, phrase(e.key)});
+
+    std::sort(sorted.begin(), sorted.end(), [](const std::pair<uint64_t, string> &a, const std::pair<uint64_t, string> &b)
+    {
+	   return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    if (limit != 0 && sorted.size() > limit)
+	   sorted.resize(limit);
+
+    for (const auto &p : sorted)
+	   cout << p.second << " - " << p.first << endl;
+}
+
+// ##########################################################
+// @par Name
+// intern
+// @purpose
+// gets the id of a word, assigning the next id to new words
+// @param [in] :
+// const string &word - word to look up
+// @return
+// uint32_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint32_t NGramCount::intern(const string &word)
+{
+    auto it = this->ids.find(word);
+    if (it != this->ids.end())
+	   return it->second;
+
+    uint32_t id = static_cast<uint32_t>(this->words.size());
+    this->ids.emplace(word, id);
+    this->words.push_back(word);
+    return id;
+}
+
+// ##########################################################
+// @par Name
+// packKey
+// @purpose
+// packs n word ids into a key
+// @param [in] :
+// const uint32_t *wordIds - ids of the words in text order
+// @return
+// NGramKey
+// @par References
+// None
+// @par Notes
+// ids are stored plus one so an all zero key never occurs
+//###########################################################
+NGramKey NGramCount::packKey(const uint32_t *wordIds) const
+{
+    NGramKey key{0, 0};
+    for (unsigned i = 0; i < this->n; i++)
+    {
+	   uint64_t lane = uint64_t(wordIds[i] + 1) << (32 * (i % 2));
+	   if (i < 2)
+		  key.lo |= lane;
+	   else
+		  key.hi |= lane;
+    }
+    return key;
+}
+
+// ##########################################################
+// @par Name
+// findSlot
+// @purpose
+// finds the table slot of a key, or the empty slot where it
+// would go
+// @param [in] :
+// const NGramKey &key - packed n-gram
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// linear probing
+//###########################################################
+size_t NGramCount::findSlot(const NGramKey &key) const
+{
+    size_t mask = this->table.size() - 1;
+    size_t slot = mixHash(key.lo ^ mixHash(key.hi)) & mask;
+    while (this->table[slot].wordCount != 0)
+    {
+	   if (this->table[slot].key.lo == key.lo && this->table[slot].key.hi == key.hi)
+		  break;
+	   slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+// ##########################################################
+// @par Name
+// increment
+// @purpose
+// adds to the count of a packed n-gram
+// @param [in] :
+// const NGramKey &key - packed n-gram
+// uint64_t count - number of occurrences to add
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the table doubles past 70% load
+//###########################################################
+void NGramCount::increment(const NGramKey &key, uint64_t count)
+{
+    NGramEntry &e = this->table[findSlot(key)];
+    if (e.wordCount != 0)
+    {
+	   e.wordCount += count;
+	   return;
+    }
+
+    e.key = key;
+    e.wordCount = count;
+    if (++this->used * 10 > this->table.size() * 7)
+	   grow();
+}
+
+// ##########################################################
+// @par Name
+// grow
+// @purpose
+// doubles the n-gram table
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void NGramCount::grow()
+{
+    vector<NGramEntry> old(this->table.size() * 2);
+    old.swap(this->table);
+    this->used = 0;
+    for (const NGramEntry &e : old)
+	   if (e.wordCount != 0)
+		  increment(e.key, e.wordCount);
+}
+
+// ##########################################################
+// @par Name
+// phrase
+// @purpose
+// unpacks a key back into its words
+// @param [in] :
+// const NGramKey &key - packed n-gram
+// @return
+// string - the words separated by spaces
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+string NGramCount::phrase(const NGramKey &key) const
+{
+    string result;
+    for (unsigned i = 0; i < this->n; i++)
+    {
+	   uint64_t packed = i < 2 ? key.lo : key.hi;
+	   uint32_t id = static_cast<uint32_t>(packed >> (32 * (i % 2))) - 1;
+	   if (i > 0)
+		  result += ' ';
+	   result += this->words[id];
+    }
+    return result;
+}
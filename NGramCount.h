@@ -0,0 +1,68 @@
+//##########################################################
+// File: NGramCount.h
+// Description: This file contains the class definition for
+//			 NGramCount, which counts runs of n consecutive
+//			 words keyed by interned word ids
+//##########################################################
+
+#ifndef NGRAM_COUNT_H
+#define NGRAM_COUNT_H
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+// longest n-gram that fits in a packed key of four 32 bit ids
+const unsigned MAX_NGRAM = 4;
+
+struct NGramKey
+{
+    uint64_t lo;
+    uint64_t hi;
+};
+
+struct NGramEntry
+{
+    NGramKey key;
+    uint64_t wordCount;
+};
+
+struct WordHash
+{
+    size_t operator()(const string &word) const;
+};
+
+class NGramCount
+{
+private:
+    unsigned n;
+    size_t seen;
+    uint32_t window[MAX_NGRAM];
+    std::unordered_map<string, uint32_t, WordHash> ids;
+    vector<string> words;
+    vector<NGramEntry> table;
+    size_t used;
+
+    uint32_t intern(const string &word);
+    NGramKey packKey(const uint32_t *wordIds) const;
+    size_t findSlot(const NGramKey &key) const;
+    void increment(const NGramKey &key, uint64_t count);
+    void grow();
+    string phrase(const NGramKey &key) const;
+
+public:
+    explicit NGramCount(unsigned size = 2);
+
+    void add(const string &word);
+    void reset();
+    uint64_t count(const vector<string> &query) const;
+    size_t size() const;
+    size_t memoryUsage() const;
+    void display(size_t limit = 0) const;
+};
+
+#endif
@@ -0,0 +1,245 @@
+//##########################################################
+// File: NodePool.h
+// Description: This file contains the NodePool template
+//			 class, which hands out tree nodes from large
+//			 chunks of memory
+//##########################################################
+
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// nodes in the first chunk; each later chunk doubles in size
+const size_t POOL_FIRST_CHUNK = 64;
+
+template<class N>
+class NodePool
+{
+private:
+    union Slot
+    {
+	   Slot *next;
+	   alignas(N) unsigned char storage[sizeof(N)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    Slot *freeList{};
+    Slot *current{};
+    size_t remaining{};
+    size_t nextChunk{POOL_FIRST_CHUNK};
+
+    void addChunk(size_t n);
+
+public:
+    NodePool() = default;
+    NodePool(const NodePool &pool) = delete;
+    NodePool &operator=(const NodePool &pool) = delete;
+    NodePool(NodePool &&pool) noexcept;
+    NodePool &operator=(NodePool &&pool) noexcept;
+
+    N *create();
+    void destroy(N *node);
+    void reserve(size_t n);
+    void release();
+    void swap(NodePool &pool) noexcept;
+};
+
+// ##########################################################
+// @par Name
+// NodePool
+// @purpose
+// takes over the chunks of another pool
+// @param [in] :
+// NodePool &&pool - pool left empty
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class N>
+NodePool<N>::NodePool(NodePool &&pool) noexcept
+{
+    swap(pool);
+}
+
+// ##########################################################
+// @par Name
+// operator=
+// @purpose
+// exchanges chunks with another pool
+// @param [in] :
+// NodePool &&pool - pool receiving this pool's chunks
+// @return
+// NodePool &
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class N>
+NodePool<N> &NodePool<N>::operator=(NodePool &&pool) noexcept
+{
+    swap(pool);
+    return *this;
+}
+
+// ##########################################################
+// @par Name
+// create
+// @purpose
+// gets memory for one node and value-initializes the node
+// @param [in] :
+// None
+// @return
+// N *
+// @par References
+// None
+// @par Notes
+// freed nodes are reused before the current chunk is used
+//###########################################################
+template<class N>
+N *NodePool<N>::create()
+{
+    Slot *slot;
+    if (this->freeList != nullptr)
+    {
+	   slot = this->freeList;
+	   this->freeList = slot->next;
+    }
+    else
+    {
+	   if (this->remaining == 0)
+		  addChunk(this->nextChunk);
+	   slot = this->current++;
+	   this->remaining--;
+    }
+    return new (slot->storage) N();
+}
+
+// ##########################################################
+// @par Name
+// destroy
+// @purpose
+// destroys a node and keeps its memory for the next create
+// @param [in] :
+// N *node - node made by create
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class N>
+void NodePool<N>::destroy(N *node)
+{
+    node->~N();
+    Slot *slot = reinterpret_cast<Slot *>(node);
+    slot->next = this->freeList;
+    this->freeList = slot;
+}
+
+// ##########################################################
+// @par Name
+// reserve
+// @purpose
+// makes sure the next n creates come from one chunk
+// @param [in] :
+// size_t n - number of nodes about to be created
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// used by bulk copies so all of their nodes are allocated at
+// once and sit next to each other; the free list is still used
+// first, so reserve on an empty pool for that guarantee
+//###########################################################
+template<class N>
+void NodePool<N>::reserve(size_t n)
+{
+    if (this->remaining < n)
+	   addChunk(n);
+}
+
+// ##########################################################
+// @par Name
+// release
+// @purpose
+// frees every chunk
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// nodes still alive are not destroyed, the owner must have
+// destroyed them first when N has a destructor
+//###########################################################
+template<class N>
+void NodePool<N>::release()
+{
+    this->chunks.clear();
+    this->freeList = nullptr;
+    this->current = nullptr;
+    this->remaining = 0;
+    this->nextChunk = POOL_FIRST_CHUNK;
+}
+
+// ##########################################################
+// @par Name
+// swap
+// @purpose
+// exchanges chunks with another pool
+// @param [in] :
+// NodePool &pool - pool to swap with
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class N>
+void NodePool<N>::swap(NodePool &pool) noexcept
+{
+    std::swap(this->chunks, pool.chunks);
+    std::swap(this->freeList, pool.freeList);
+    std::swap(this->current, pool.current);
+    std::swap(this->remaining, pool.remaining);
+    std::swap(this->nextChunk, pool.nextChunk);
+}
+
+// ##########################################################
+// @par Name
+// addChunk
+// @purpose
+// allocates a chunk of n nodes and makes it the current chunk
+// @param [in] :
+// size_t n - nodes in the chunk
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// whatever was left of the previous chunk stays unused until
+// release, so reserved nodes are never mixed with older ones
+//###########################################################
+template<class N>
+void NodePool<N>::addChunk(size_t n)
+{
+    this->chunks.emplace_back(new Slot[n]);
+    this->current = this->chunks.back().get();
+    this->remaining = n;
+    if (n >= this->nextChunk)
+	   this->nextChunk = n * 2;
+}
+
+#endif
@@ -0,0 +1,145 @@
+//##########################################################
+// File: ParallelSort.h
+// Description: This file contains a stable merge sort that
+//			 spreads its work over several threads
+//##########################################################
+
+#ifndef PARALLEL_SORT_H
+#define PARALLEL_SORT_H
+#include "Trace.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+// arrays shorter than this are sorted on the calling thread
+const size_t PARALLEL_SORT_MIN = 1 << 16;
+
+// ##########################################################
+// @par Name
+// mergeSplit
+// @purpose
+// finds how many elements of the first run are among the first
+// k elements of the merge of two sorted runs
+// @param [in] :
+// const T *a - first run
+// size_t n - length of the first run
+// const T *b - second run
+// size_t m - length of the second run
+// size_t k - number of merged elements
+// Compare comp - strict weak order of the runs
+// @return
+// size_t
+// @par References
+// Odeh et al., Merge Path - A Visually Intuitive Approach to
+// Parallel Merging
+// @par Notes
+// equal elements are taken from the first run first, as
+// std::merge does, so splitting the merge keeps it stable
+//###########################################################
+template<class T, class Compare>
+size_t mergeSplit(const T *a, size_t n, const T *b, size_t m, size_t k, Compare comp)
+{
+    size_t low = k > m ? k - m : 0;
+    size_t high = k < n ? k : n;
+    while (low < high)
+    {
+	   size_t i = low + (high - low) / 2;
+	   size_t j = k - i;
+	   if (j > 0 && !comp(b[j - 1], a[i]))
+		  low = i + 1;
+	   else
+		  high = i;
+    }
+    return low;
+}
+
+// ##########################################################
+// @par Name
+// parallelStableSort
+// @purpose
+// sorts an array, keeping equal elements in their order
+// @param [in] :
+// std::vector<T> &data - array to be sorted
+// Compare comp - strict weak order of the elements
+// unsigned threads - threads to use, 0 for one per core
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the array is cut into one run per thread and each run is
+// sorted with std::stable_sort. Pairs of runs are then merged
+// until one is left; every merge is split at merge path points
+// so all threads stay busy in the last rounds too. Needs a
+// second array the size of the first
+//###########################################################
+template<class T, class Compare>
+void parallelStableSort(std::vector<T> &data, Compare comp, unsigned threads = 0)
+{
+    if (threads == 0)
+	   threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t n = data.size();
+    if (threads == 1 || n < PARALLEL_SORT_MIN)
+    {
+	   std::stable_sort(data.begin(), data.end(), comp);
+	   return;
+    }
+
+    size_t runs = 1;
+    while (runs * 2 <= threads)
+	   runs *= 2;
+    std::vector<size_t> bounds(runs + 1);
+    for (size_t r = 0; r <= runs; r++)
+	   bounds[r] = n * r / runs;
+
+    std::vector<std::thread> workers;
+    for (size_t r = 0; r < runs; r++)
+	   workers.emplace_back([&data, &bounds, r, comp]()
+	   {
+		  TraceLog::nameThread("sort worker");
+		  TraceSpan span("sort run");
+		  std::stable_sort(data.begin() + bounds[r], data.begin() + bounds[r + 1], comp);
+	   });
+    for (std::thread &worker : workers)
+	   worker.join();
+
+    std::vector<T> buffer(n);
+    T *from = data.data();
+    T *to = buffer.data();
+    for (size_t width = 1; width < runs; width *= 2)
+    {
+	   // each pair of runs gets an equal share of the threads
+	   size_t pieces = std::max<size_t>(1, threads / (runs / (2 * width)));
+	   workers.clear();
+	   for (size_t r = 0; r < runs; r += 2 * width)
+	   {
+		  const T *a = from + bounds[r];
+		  size_t lenA = bounds[r + width] - bounds[r];
+		  const T *b = from + bounds[r + width];
+		  size_t lenB = bounds[r + 2 * width] - bounds[r + width];
+		  T *out = to + bounds[r];
+		  for (size_t p = 0; p < pieces; p++)
+			 workers.emplace_back([=]()
+			 {
+				TraceLog::nameThread("sort worker");
+				TraceSpan span("merge sorted runs");
+				size_t start = (lenA + lenB) * p / pieces;
+				size_t end = (lenA + lenB) * (p + 1) / pieces;
+				size_t i = mergeSplit(a, lenA, b, lenB, start, comp);
+				size_t iEnd = mergeSplit(a, lenA, b, lenB, end, comp);
+				std::merge(std::make_move_iterator(a + i), std::make_move_iterator(a + iEnd),
+						   std::make_move_iterator(b + (start - i)), std::make_move_iterator(b + (end - iEnd)),
+						   out + start, comp);
+			 });
+	   }
+	   for (std::thread &worker : workers)
+		  worker.join();
+	   std::swap(from, to);
+    }
+    if (from != data.data())
+	   std::move(buffer.begin(), buffer.end(), data.begin());
+}
+
+#endif
@@ -0,0 +1,387 @@
+//##########################################################
+// File: PhaseProfiler.cpp
+// Description: This file contains the class implementation
+//			 for PhaseProfiler
+//##########################################################
+
+#include "PhaseProfiler.h"
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// ##########################################################
+// @par Name
+// openEvent
+// @purpose
+// opens one hardware counter of the calling thread
+// @param [in] :
+// uint32_t type - perf event type
+// uint64_t config - event within the type
+// int group - fd of the group leader, -1 to start a group
+// @return
+// int - fd of the counter, -1 when it cannot be opened
+// @par References
+// None
+// @par Notes
+// only user space is counted so the counters open under the
+// default perf_event_paranoid setting of 2
+//###########################################################
+static int openEvent(uint32_t type, uint64_t config, int group)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+}
+
+// ##########################################################
+// @par Name
+// PhaseProfiler
+// @purpose
+// opens the counters and starts them running
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the counters follow the thread that creates the profiler,
+// so work done by the BlockReader's thread shows up only as
+// the wall-clock time spent waiting for it in the read phase
+//###########################################################
+PhaseProfiler::PhaseProfiler() : leader(-1), opened(0), phases(), tokens(0), active(false), current(PHASE_READ), startValues()
+{
+    for (int e = 0; e < EVENT_COUNT; e++)
+    {
+	   this->fds[e] = -1;
+	   this->slots[e] = -1;
+    }
+    openCounters();
+}
+
+// ##########################################################
+// @par Name
+// ~PhaseProfiler
+// @purpose
+// closes the counters
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+PhaseProfiler::~PhaseProfiler()
+{
+    for (int e = 0; e < EVENT_COUNT; e++)
+	   if (this->fds[e] != -1)
+		  close(this->fds[e]);
+}
+
+// ##########################################################
+// @par Name
+// openCounters
+// @purpose
+// opens the events as one group so they are read together
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// cycles lead the group; without them no counter is used. A
+// later event the CPU lacks is left out and reported as n/a.
+// Cache misses are the generic event, which counts last level
+// cache misses on most CPUs
+//###########################################################
+void PhaseProfiler::openCounters()
+{
+    static const uint64_t configs[EVENT_COUNT] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+    for (int e = 0; e < EVENT_COUNT; e++)
+    {
+	   this->fds[e] = openEvent(PERF_TYPE_HARDWARE, configs[e], this->leader);
+	   if (this->fds[e] == -1)
+	   {
+		  if (e == EVENT_CYCLES)
+		  {
+			 int error = errno;
+			 if (error == ENOENT || error == ENODEV || error == EOPNOTSUPP)
+				this->unavailable = "no hardware counters on this CPU";
+			 else
+				this->unavailable = std::strerror(error);
+			 if (error == EACCES || error == EPERM)
+				this->unavailable += ", see /proc/sys/kernel/perf_event_paranoid";
+			 return;
+		  }
+		  continue;
+	   }
+	   if (e == EVENT_CYCLES)
+		  this->leader = this->fds[e];
+	   this->slots[e] = this->opened++;
+    }
+
+    ioctl(this->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(this->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+// ##########################################################
+// @par Name
+// sample
+// @purpose
+// reads every counter of the group at once
+// @param [in] :
+// uint64_t *values - gets the time enabled, the time running
+//				  and then one value per opened event
+// @return
+// bool - false when the counters could not be read
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool PhaseProfiler::sample(uint64_t *values) const
+{
+    uint64_t buffer[3 + EVENT_COUNT];
+    ssize_t want = static_cast<ssize_t>((3 + this->opened) * sizeof(uint64_t));
+    if (this->leader == -1 || ::read(this->leader, buffer, want) != want)
+	   return false;
+    for (int i = 0; i < 2 + this->opened; i++)
+	   values[i] = buffer[1 + i];
+    return true;
+}
+
+// ##########################################################
+// @par Name
+// begin
+// @purpose
+// starts timing a phase
+// @param [in] :
+// Phase phase - phase about to run
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// phases do not nest; a phase still running is ended first
+//###########################################################
+void PhaseProfiler::begin(Phase phase)
+{
+    if (this->active)
+	   end();
+    this->current = phase;
+    this->active = true;
+    sample(this->startValues);
+    this->startTime = std::chrono::steady_clock::now();
+}
+
+// ##########################################################
+// @par Name
+// end
+// @purpose
+// stops timing the current phase and adds it to the totals
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// when the kernel multiplexed the counters, each value is
+// scaled by how long the group was enabled over how long it
+// actually ran
+//###########################################################
+void PhaseProfiler::end()
+{
+    if (!this->active)
+	   return;
+    auto now = std::chrono::steady_clock::now();
+    uint64_t values[EVENT_COUNT + 2];
+    Totals &t = this->phases[this->current];
+    t.seconds += std::chrono::duration<double>(now - this->startTime).count();
+    t.entries++;
+    this->active = false;
+
+    if (!sample(values))
+	   return;
+    uint64_t enabled = values[0] - this->startValues[0];
+    uint64_t running = values[1] - this->startValues[1];
+    double scale = running ? static_cast<double>(enabled) / running : 0.0;
+    for (int e = 0; e < EVENT_COUNT; e++)
+	   if (this->slots[e] != -1)
+		  t.values[e] += (values[2 + this->slots[e]] - this->startValues[2 + this->slots[e]]) * scale;
+}
+
+// ##########################################################
+// @par Name
+// addTokens
+// @purpose
+// adds to the number of words the misses are divided by
+// @param [in] :
+// uint64_t count - words tokenized
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void PhaseProfiler::addTokens(uint64_t count)
+{
+    this->tokens += count;
+}
+
+// ##########################################################
+// @par Name
+// hasCounters
+// @purpose
+// checks if the hardware counters are being read
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool PhaseProfiler::hasCounters() const
+{
+    return this->leader != -1;
+}
+
+// ##########################################################
+// @par Name
+// report
+// @purpose
+// displays the time, IPC and misses per token of each phase
+// that ran
+// @param [in] :
+// std::ostream &out - stream to display the report on
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// without counters only the wall-clock time is displayed
+//###########################################################
+void PhaseProfiler::report(std::ostream &out) const
+{
+    out << "profile tokens - " << this->tokens << std::endl;
+    if (!hasCounters())
+	   out << "profile counters - unavailable (" << this->unavailable << "), wall-clock time only" << std::endl;
+
+    out << std::fixed;
+    for (int p = 0; p < PHASE_COUNT; p++)
+    {
+	   const Totals &t = this->phases[p];
+	   if (t.entries == 0)
+		  continue;
+	   out << "profile " << name(static_cast<Phase>(p)) << " - " << std::setprecision(2) << t.seconds * 1000 << " ms";
+	   if (hasCounters())
+	   {
+		  double perToken = this->tokens ? 1.0 / this->tokens : 0.0;
+		  out << ", " << std::setprecision(0) << t.values[EVENT_CYCLES] << " cycles";
+		  if (this->slots[EVENT_INSTRUCTIONS] != -1 && t.values[EVENT_CYCLES] > 0)
+			 out << ", IPC " << std::setprecision(2) << t.values[EVENT_INSTRUCTIONS] / t.values[EVENT_CYCLES];
+		  else
+			 out << ", IPC n/a";
+		  if (this->slots[EVENT_LLC_MISSES] != -1)
+			 out << ", LLC misses/token " << std::setprecision(4) << t.values[EVENT_LLC_MISSES] * perToken;
+		  else
+			 out << ", LLC misses/token n/a";
+		  if (this->slots[EVENT_BRANCH_MISSES] != -1)
+			 out << ", branch misses/token " << std::setprecision(4) << t.values[EVENT_BRANCH_MISSES] * perToken;
+		  else
+			 out << ", branch misses/token n/a";
+	   }
+	   out << std::endl;
+    }
+    out << std::defaultfloat;
+}
+
+// ##########################################################
+// @par Name
+// name
+// @purpose
+// gets the name a phase is reported under
+// @param [in] :
+// Phase phase - phase to name
+// @return
+// const char *
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+const char *PhaseProfiler::name(Phase phase)
+{
+    switch (phase)
+    {
+    case PHASE_READ:
+	   return "read";
+    case PHASE_TOKENIZE:
+	   return "tokenize";
+    case PHASE_INSERT:
+	   return "insert";
+    case PHASE_DISPLAY:
+	   return "display";
+    default:
+	   return "unknown";
+    }
+}
+
+// ##########################################################
+// @par Name
+// ProfileScope
+// @purpose
+// begins a phase
+// @param [in] :
+// PhaseProfiler *p - profiler to report to, may be null
+// Phase phase - phase being entered
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+ProfileScope::ProfileScope(PhaseProfiler *p, Phase phase) : profiler(p)
+{
+    if (this->profiler != nullptr)
+	   this->profiler->begin(phase);
+}
+
+// ##########################################################
+// @par Name
+// ~ProfileScope
+// @purpose
+// ends the phase begun by the constructor
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+ProfileScope::~ProfileScope()
+{
+    if (this->profiler != nullptr)
+	   this->profiler->end();
+}
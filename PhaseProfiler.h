@@ -0,0 +1,93 @@
+//##########################################################
+// File: PhaseProfiler.h
+// Description: This file contains the class definition for
+//			 PhaseProfiler, which counts cycles, instructions
+//			 and misses separately for each phase of a count
+//##########################################################
+
+#ifndef PHASE_PROFILER_H
+#define PHASE_PROFILER_H
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+using std::string;
+
+// parts of a count that are profiled separately
+enum Phase
+{
+    PHASE_READ,
+    PHASE_TOKENIZE,
+    PHASE_INSERT,
+    PHASE_DISPLAY,
+    PHASE_COUNT
+};
+
+// hardware events counted in every phase
+enum ProfileEvent
+{
+    EVENT_CYCLES,
+    EVENT_INSTRUCTIONS,
+    EVENT_LLC_MISSES,
+    EVENT_BRANCH_MISSES,
+    EVENT_COUNT
+};
+
+class PhaseProfiler
+{
+private:
+    struct Totals
+    {
+	   double values[EVENT_COUNT];
+	   double seconds;
+	   uint64_t entries;
+    };
+
+    int leader;
+    int fds[EVENT_COUNT];
+    int slots[EVENT_COUNT];
+    int opened;
+    string unavailable;
+
+    Totals phases[PHASE_COUNT];
+    uint64_t tokens;
+    bool active;
+    Phase current;
+    uint64_t startValues[EVENT_COUNT + 2];
+    std::chrono::steady_clock::time_point startTime;
+
+    void openCounters();
+    bool sample(uint64_t *values) const;
+
+public:
+    PhaseProfiler();
+    ~PhaseProfiler();
+    PhaseProfiler(const PhaseProfiler &) = delete;
+    PhaseProfiler &operator=(const PhaseProfiler &) = delete;
+
+    void begin(Phase phase);
+    void end();
+    void addTokens(uint64_t count);
+    bool hasCounters() const;
+    void report(std::ostream &out) const;
+
+    static const char *name(Phase phase);
+};
+
+// times one phase for as long as it is in scope; a null
+// profiler makes it do nothing
+class ProfileScope
+{
+private:
+    PhaseProfiler *profiler;
+
+public:
+    ProfileScope(PhaseProfiler *p, Phase phase);
+    ~ProfileScope();
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+};
+
+#endif
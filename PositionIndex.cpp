@@ -0,0 +1,277 @@
+//##########################################################
+// File: PositionIndex.cpp
+// Description: This file contains the class implementation
+//			 for PositionIndex
+//##########################################################
+
+#include "PositionIndex.h"
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+// ##########################################################
+// @par Name
+// PositionIndex
+// @purpose
+// creates an empty index
+// @param [in] :
+// PositionMode m - POSITION_OFFSETS records the byte offset
+//			    and line of every occurrence, POSITION_LINES
+//			    only each line a word appears on
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+PositionIndex::PositionIndex(PositionMode m) : mode(m), postings(0) {}
+
+// ##########################################################
+// @par Name
+// add
+// @purpose
+// records one occurrence of a word
+// @param [in] :
+// uint32_t id - id of the word that was read
+// uint64_t offset - byte offset of the word in the text
+// uint64_t line - line the word is on, counted from 1
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// occurrences arrive in increasing order, so the deltas are
+// never negative. In line mode a repeat on the same line is
+// not recorded. Ids are expected to be handed out densely
+// from 0, as tree node indices are
+//###########################################################
+void PositionIndex::add(uint32_t id, uint64_t offset, uint64_t line)
+{
+    if (id >= this->lists.size())
+	   this->lists.resize(id + 1, PostingList{vector<uint8_t>(), 0, 0, 0});
+    PostingList &list = this->lists[id];
+    if (this->mode == POSITION_LINES)
+    {
+	   if (list.entries > 0 && line == list.lastLine)
+		  return;
+	   putVarint(list.bytes, line - list.lastLine);
+    }
+    else
+    {
+	   putVarint(list.bytes, offset - list.lastOffset);
+	   putVarint(list.bytes, line - list.lastLine);
+    }
+    list.lastOffset = offset;
+    list.lastLine = line;
+    list.entries++;
+    this->postings++;
+}
+
+// ##########################################################
+// @par Name
+// find
+// @purpose
+// gets every recorded position of a word
+// @param [in] :
+// uint32_t id - id of the word, an id never added has no
+//			  positions
+// @return
+// vector<Posting> - positions in text order; in line mode the
+//			   offsets are 0
+// @par References
+// None
+// @par Notes
+// only the word's own list is decoded, nothing is rescanned
+//###########################################################
+vector<Posting> PositionIndex::find(uint32_t id) const
+{
+    vector<Posting> result;
+    if (id >= this->lists.size())
+	   return result;
+
+    const PostingList &list = this->lists[id];
+    result.reserve(list.entries);
+    Posting current{0, 0};
+    size_t i = 0;
+    auto getVarint = [&list, &i]()
+    {
+	   uint64_t value = 0;
+	   for (unsigned shift = 0; i < list.bytes.size(); shift += 7)
+	   {
+		  uint8_t byte = list.bytes[i++];
+		  value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		  if ((byte & 0x80) == 0)
+			 break;
+	   }
+	   return value;
+    };
+    while (i < list.bytes.size())
+    {
+	   if (this->mode == POSITION_OFFSETS)
+		  current.offset += getVarint();
+	   current.line += getVarint();
+	   result.push_back(current);
+    }
+    return result;
+}
+
+// ##########################################################
+// @par Name
+// display
+// @purpose
+// displays every recorded position of a word
+// @param [in] :
+// const string &word - word being displayed
+// uint32_t id - id of the word
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void PositionIndex::display(const string &word, uint32_t id) const
+{
+    vector<Posting> found = find(id);
+    cout << word << " - " << found.size() << (this->mode == POSITION_LINES ? " lines" : " occurrences") << endl;
+    for (const Posting &posting : found)
+    {
+	   if (this->mode == POSITION_LINES)
+		  cout << "line " << posting.line << endl;
+	   else
+		  cout << "line " << posting.line << ", offset " << posting.offset << endl;
+    }
+}
+
+// ##########################################################
+// @par Name
+// append
+// @purpose
+// copies the postings of one word of another index to the end
+// of this one
+// @param [in] :
+// const PositionIndex &other - index to copy from
+// uint32_t id - id of the word in other
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the word gets the next id here, so words copied in a new
+// order carry their postings along. The lists stay encoded
+//###########################################################
+void PositionIndex::append(const PositionIndex &other, uint32_t id)
+{
+    if (id < other.lists.size())
+    {
+	   this->lists.push_back(other.lists[id]);
+	   this->postings += other.lists[id].entries;
+    }
+    else
+	   this->lists.push_back(PostingList{vector<uint8_t>(), 0, 0, 0});
+}
+
+// ##########################################################
+// @par Name
+// positionMode
+// @purpose
+// gets what the postings record
+// @param [in] :
+// None
+// @return
+// PositionMode
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+PositionMode PositionIndex::positionMode() const
+{
+    return this->mode;
+}
+
+// ##########################################################
+// @par Name
+// size
+// @purpose
+// gets the number of word ids with a posting list
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t PositionIndex::size() const
+{
+    return this->lists.size();
+}
+
+// ##########################################################
+// @par Name
+// postingCount
+// @purpose
+// gets the number of postings across every word
+// @param [in] :
+// None
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t PositionIndex::postingCount() const
+{
+    return this->postings;
+}
+
+// ##########################################################
+// @par Name
+// memoryUsage
+// @purpose
+// estimates the bytes held by the index
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t PositionIndex::memoryUsage() const
+{
+    size_t bytes = this->lists.capacity() * sizeof(PostingList);
+    for (const PostingList &list : this->lists)
+	   bytes += list.bytes.capacity();
+    return bytes;
+}
+
+// ##########################################################
+// @par Name
+// putVarint
+// @purpose
+// appends an unsigned integer 7 bits at a time
+// @param [in] :
+// uint64_t value - integer to append
+// @return
+// None
+// @par References
+// vector<uint8_t> &bytes - list being written
+// @par Notes
+// the high bit of each byte marks that another byte follows
+//###########################################################
+void PositionIndex::putVarint(vector<uint8_t> &bytes, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+	   bytes.push_back(static_cast<uint8_t>((value & 0x7F) | 0x80));
+	   value >>= 7;
+    }
+    bytes.push_back(static_cast<uint8_t>(value));
+}
@@ -0,0 +1,68 @@
+//##########################################################
+// File: PositionIndex.h
+// Description: This file contains the class definition for
+//			 PositionIndex, which records where each word
+//			 appears in compressed posting lists kept by
+//			 word id
+//##########################################################
+
+#ifndef POSITION_INDEX_H
+#define POSITION_INDEX_H
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+// what a posting records about each occurrence
+enum PositionMode
+{
+    POSITION_OFFSETS,
+    POSITION_LINES
+};
+
+struct Posting
+{
+    uint64_t offset;
+    uint64_t line;
+};
+
+class PositionIndex
+{
+private:
+    // postings are varint encoded deltas from the previous
+    // posting of the same word, so most take one or two bytes
+    struct PostingList
+    {
+	   vector<uint8_t> bytes;
+	   uint64_t lastOffset;
+	   uint64_t lastLine;
+	   uint64_t entries;
+    };
+
+    PositionMode mode;
+    // list i belongs to the word whose id is i; the ids come
+    // from whatever holds the words, so the words are not kept
+    // a second time here
+    vector<PostingList> lists;
+    uint64_t postings;
+
+    static void putVarint(vector<uint8_t> &bytes, uint64_t value);
+
+public:
+    explicit PositionIndex(PositionMode m = POSITION_OFFSETS);
+
+    void add(uint32_t id, uint64_t offset, uint64_t line);
+    void append(const PositionIndex &other, uint32_t id);
+    vector<Posting> find(uint32_t id) const;
+    void display(const string &word, uint32_t id) const;
+
+    PositionMode positionMode() const;
+    size_t size() const;
+    uint64_t postingCount() const;
+    size_t memoryUsage() const;
+};
+
+#endif
@@ -0,0 +1,302 @@
+//##########################################################
+// File: QuerySet.cpp
+// Description: This file contains the class implementation
+//			 for QuerySet
+//##########################################################
+
+#include "QuerySet.h"
+#include "Hash.h"
+#include "BlockReader.h"
+#include "Tokenizer.h"
+#include <algorithm>
+#include <iostream>
+#include <unordered_set>
+
+using std::cout;
+using std::endl;
+
+// marks a slot no word was placed in
+const uint32_t EMPTY_SLOT = UINT32_MAX;
+
+// ##########################################################
+// @par Name
+// QuerySet
+// @purpose
+// compiles a list of words into a perfect hash table
+// @param [in] :
+// const vector<string> &queries - words to count; repeats are
+//							   counted once
+// @return
+// None
+// @par References
+// Belazzougui, Botelho and Dietzfelbinger, "Hash, displace,
+// and compress" (CHD)
+// @par Notes
+// every word gets its own slot, so a lookup is one hash, one
+// displacement read and one slot read. A table of the lengths
+// used by each first byte turns away most other words before
+// they are hashed
+//###########################################################
+QuerySet::QuerySet(const vector<string> &queries) : lengths()
+{
+    std::unordered_set<string> seen;
+    vector<uint64_t> hashes;
+    for (const string &q : queries)
+    {
+	   if (q.empty() || !seen.insert(q).second)
+		  continue;
+	   this->terms.push_back(q);
+	   hashes.push_back(hashWord(q));
+	   this->lengths[static_cast<uint8_t>(q[0])] |= uint64_t(1) << std::min<size_t>(q.size(), 63);
+    }
+    this->counts.assign(this->terms.size(), 0);
+
+    size_t numSlots = std::max<size_t>(1, this->terms.size() + this->terms.size() / 4);
+    while (!place(hashes, numSlots))
+	   numSlots *= 2;
+}
+
+// ##########################################################
+// @par Name
+// place
+// @purpose
+// finds a displacement for every bucket so no two words share
+// a slot
+// @param [in] :
+// const vector<uint64_t> &hashes - hash of each word
+// size_t numSlots - slots in the table
+// @return
+// bool - false if some bucket could not be placed
+// @par References
+// None
+// @par Notes
+// the largest buckets are placed first while the table is
+// still empty, which keeps the displacements small
+//###########################################################
+bool QuerySet::place(const vector<uint64_t> &hashes, size_t numSlots)
+{
+    size_t numBuckets = std::max<size_t>(1, (hashes.size() + QUERY_BUCKET_SIZE - 1) / QUERY_BUCKET_SIZE);
+    vector<vector<uint32_t>> buckets(numBuckets);
+    for (size_t t = 0; t < hashes.size(); t++)
+	   buckets[hashes[t] % numBuckets].push_back(static_cast<uint32_t>(t));
+    vector<uint32_t> order(numBuckets);
+    for (size_t b = 0; b < numBuckets; b++)
+	   order[b] = static_cast<uint32_t>(b);
+    std::stable_sort(order.begin(), order.end(), [&buckets](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    this->slots.assign(numSlots, Slot{0, EMPTY_SLOT});
+    this->displace.assign(numBuckets, 0);
+    vector<size_t> chosen;
+    for (uint32_t b : order)
+    {
+	   const vector<uint32_t> &bucket = buckets[b];
+	   if (bucket.empty())
+		  break;
+
+	   uint32_t d = 0;
+	   for (;; d++)
+	   {
+		  if (d == QUERY_MAX_DISPLACE)
+			 return false;
+		  chosen.clear();
+		  for (uint32_t t : bucket)
+		  {
+			 size_t slot = slotOf(hashes[t], d);
+			 if (this->slots[slot].term != EMPTY_SLOT || std::find(chosen.begin(), chosen.end(), slot) != chosen.end())
+				break;
+			 chosen.push_back(slot);
+		  }
+		  if (chosen.size() == bucket.size())
+			 break;
+	   }
+
+	   this->displace[b] = d;
+	   for (size_t i = 0; i < bucket.size(); i++)
+		  this->slots[chosen[i]] = Slot{hashes[bucket[i]], bucket[i]};
+    }
+    return true;
+}
+
+// ##########################################################
+// @par Name
+// slotOf
+// @purpose
+// gets the slot of a hash under a displacement
+// @param [in] :
+// uint64_t hash - hash of the word
+// uint32_t d - displacement of the word's bucket
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t QuerySet::slotOf(uint64_t hash, uint32_t d) const
+{
+    return mixHash(hash ^ (d * 0x9e3779b97f4a7c15ULL)) % this->slots.size();
+}
+
+// ##########################################################
+// @par Name
+// find
+// @purpose
+// gets the index of a word in the set
+// @param [in] :
+// const string &word - word to look up
+// @return
+// long - index of the word, -1 if it is not in the set
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+long QuerySet::find(const string &word) const
+{
+    size_t len = word.size();
+    if (len == 0 || !((this->lengths[static_cast<uint8_t>(word[0])] >> std::min<size_t>(len, 63)) & 1))
+	   return -1;
+
+    uint64_t hash = hashWord(word);
+    const Slot &slot = this->slots[slotOf(hash, this->displace[hash % this->displace.size()])];
+    if (slot.term == EMPTY_SLOT || slot.hash != hash || this->terms[slot.term] != word)
+	   return -1;
+    return static_cast<long>(slot.term);
+}
+
+// ##########################################################
+// @par Name
+// add
+// @purpose
+// counts a word if it is in the set
+// @param [in] :
+// const string &word - word read from the file
+// @return
+// bool - true if the word was counted
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool QuerySet::add(const string &word)
+{
+    long t = find(word);
+    if (t < 0)
+	   return false;
+    this->counts[t]++;
+    return true;
+}
+
+// ##########################################################
+// @par Name
+// count
+// @purpose
+// gets the number of times a word was counted
+// @param [in] :
+// const string &word - word to be searched for
+// @return
+// uint64_t - 0 for words not in the set
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t QuerySet::count(const string &word) const
+{
+    long t = find(word);
+    return t < 0 ? 0 : this->counts[t];
+}
+
+// ##########################################################
+// @par Name
+// size
+// @purpose
+// gets the number of distinct words in the set
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t QuerySet::size() const
+{
+    return this->terms.size();
+}
+
+// ##########################################################
+// @par Name
+// memoryUsage
+// @purpose
+// estimates the bytes held by the words and the table
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t QuerySet::memoryUsage() const
+{
+    size_t bytes = this->terms.capacity() * sizeof(string) + this->counts.capacity() * sizeof(uint64_t);
+    for (const string &t : this->terms)
+	   if (t.capacity() > string().capacity())
+		  bytes += t.capacity() + 1;
+    bytes += this->slots.capacity() * sizeof(Slot) + this->displace.capacity() * sizeof(uint32_t);
+    return bytes;
+}
+
+// ##########################################################
+// @par Name
+// countQuerySet
+// @purpose
+// counts a list of words in a file without building a tree of
+// the file's other words
+// @param [in] :
+// const string &filename - file to be read
+// const vector<string> &queries - words to be counted
+// @return
+// vector<uint64_t> - count of each query in order, empty if
+//				    the file could not be read
+// @par References
+// None
+// @par Notes
+// memory stays proportional to the list however large the
+// file is; words are cleaned exactly as read does, so the
+// counts match those of a full count
+//###########################################################
+vector<uint64_t> countQuerySet(const string &filename, const vector<string> &queries)
+{
+    BlockReader file(filename);
+    if (!file.isOpen())
+    {
+	   cout << "File failed to open" << endl;
+	   return vector<uint64_t>();
+    }
+    if (!file.isSupported())
+    {
+	   cout << Decompressor::name(file.compression()) << " input is not supported by this build" << endl;
+	   return vector<uint64_t>();
+    }
+
+    QuerySet set(queries);
+    Tokenizer tokenizer;
+    auto add = [&set](const string &word) { set.add(word); };
+    const char *block;
+    size_t len;
+    while (file.next(block, len))
+	   tokenizer.feed(block, len, add);
+    tokenizer.finish(add);
+    if (file.failed())
+	   cout << "File could not be read completely" << endl;
+
+    vector<uint64_t> counts;
+    counts.reserve(queries.size());
+    for (const string &q : queries)
+	   counts.push_back(set.count(q));
+    return counts;
+}
@@ -0,0 +1,53 @@
+//##########################################################
+// File: QuerySet.h
+// Description: This file contains the class definition for
+//			 QuerySet, which counts only a fixed list of words
+//			 through a perfect hash table
+//##########################################################
+
+#ifndef QUERY_SET_H
+#define QUERY_SET_H
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+// average number of words sharing one displacement
+const size_t QUERY_BUCKET_SIZE = 4;
+// displacements tried for one bucket before the table grows
+const uint32_t QUERY_MAX_DISPLACE = 1 << 16;
+
+class QuerySet
+{
+private:
+    struct Slot
+    {
+	   uint64_t hash;
+	   uint32_t term;
+    };
+
+    vector<string> terms;
+    vector<uint64_t> counts;
+    vector<Slot> slots;
+    vector<uint32_t> displace;
+    uint64_t lengths[256];
+
+    bool place(const vector<uint64_t> &hashes, size_t numSlots);
+    size_t slotOf(uint64_t hash, uint32_t d) const;
+
+public:
+    explicit QuerySet(const vector<string> &queries);
+
+    long find(const string &word) const;
+    bool add(const string &word);
+    uint64_t count(const string &word) const;
+    size_t size() const;
+    size_t memoryUsage() const;
+};
+
+vector<uint64_t> countQuerySet(const string &filename, const vector<string> &queries);
+
+#endif
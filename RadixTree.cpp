@@ -0,0 +1,1103 @@
+//##########################################################
+// File: RadixTree.cpp
+// Description: This file contains the class implementation
+//			 for RadixTree
+//##########################################################
+
+#include "RadixTree.h"
+#include <cstring>
+#include <utility>
+#include <iostream>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using std::cout;
+using std::endl;
+
+// ##########################################################
+// @par Name
+// RadixTree
+// @purpose
+// creates an empty radix tree
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+RadixTree::RadixTree() : root(nullptr), numWords(0) {}
+
+// ##########################################################
+// @par Name
+// RadixTree
+// @purpose
+// creates a deep copy of an existing tree
+// @param [in] :
+// const RadixTree &tree - tree to be copied
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+RadixTree::RadixTree(const RadixTree &tree) : root(clone(tree.root)), numWords(tree.numWords) {}
+
+// ##########################################################
+// @par Name
+// RadixTree
+// @purpose
+// takes over the nodes of an existing tree without copying
+// them
+// @param [in] :
+// RadixTree &&tree - tree left empty
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+RadixTree::RadixTree(RadixTree &&tree) noexcept : root(nullptr), numWords(0)
+{
+    swap(tree);
+}
+
+// ##########################################################
+// @par Name
+// operator=
+// @purpose
+// replaces the contents of this tree with a deep copy
+// @param [in] :
+// const RadixTree &tree - tree to be copied
+// @return
+// RadixTree &
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+RadixTree &RadixTree::operator=(const RadixTree &tree)
+{
+    if (this != &tree)
+    {
+	   RadixTree copy(tree);
+	   swap(copy);
+    }
+    return *this;
+}
+
+// ##########################################################
+// @par Name
+// operator=
+// @purpose
+// takes over the nodes of another tree without copying them
+// @param [in] :
+// RadixTree &&tree - tree receiving this tree's old nodes
+// @return
+// RadixTree &
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+RadixTree &RadixTree::operator=(RadixTree &&tree) noexcept
+{
+    swap(tree);
+    return *this;
+}
+
+// ##########################################################
+// @par Name
+// swap
+// @purpose
+// exchanges the contents of two trees
+// @param [in] :
+// RadixTree &tree - tree to swap with
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void RadixTree::swap(RadixTree &tree) noexcept
+{
+    std::swap(this->root, tree.root);
+    std::swap(this->numWords, tree.numWords);
+}
+
+// ##########################################################
+// @par Name
+// ~RadixTree
+// @purpose
+// destructor
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+RadixTree::~RadixTree()
+{
+    makeEmpty();
+}
+
+// ##########################################################
+// @par Name
+// isEmpty
+// @purpose
+// determines if the RadixTree is empty or not
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool RadixTree::isEmpty() const
+{
+    return this->root == nullptr;
+}
+
+// ##########################################################
+// @par Name
+// contains
+// @purpose
+// determines if passed word exists within the RadixTree
+// @param [in] :
+// const string &data - word to be searched for
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool RadixTree::contains(const string &data) const
+{
+    return find(data) != nullptr;
+}
+
+// ##########################################################
+// @par Name
+// size
+// @purpose
+// gets the number of distinct words in the tree
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t RadixTree::size() const
+{
+    return this->numWords;
+}
+
+// ##########################################################
+// @par Name
+// insert
+// @purpose
+// public access to add count occurrences of a word to the tree
+// @param [in] :
+// const string &data - word to be counted
+// uint64_t count - number of occurrences to add
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// keys are stored with their terminating null byte so that
+// no word is a prefix of another inside the tree
+//###########################################################
+void RadixTree::insert(const string &data, uint64_t count)
+{
+    insert(this->root, reinterpret_cast<const uint8_t *>(data.c_str()), data.size() + 1, 0, count);
+}
+
+// ##########################################################
+// @par Name
+// count
+// @purpose
+// gets the number of times a word was counted
+// @param [in] :
+// const string &data - word to be searched for
+// @return
+// uint64_t - 0 when the word is not in the tree
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t RadixTree::count(const string &data) const
+{
+    const RadixLeaf *l = find(data);
+    return l == nullptr ? 0 : l->wordCount;
+}
+
+// ##########################################################
+// @par Name
+// prefixCount
+// @purpose
+// gets the total occurrences of every word starting with the
+// passed prefix
+// @param [in] :
+// const string &prefix - prefix the words must start with
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// each inner node keeps the total of its subtree, so this
+// costs one descent of length |prefix|
+//###########################################################
+uint64_t RadixTree::prefixCount(const string &prefix) const
+{
+    const RadixHeader *n = findPrefix(prefix);
+    if (n == nullptr)
+	   return 0;
+    if (n->type == RADIX_LEAF)
+	   return static_cast<const RadixLeaf *>(n)->wordCount;
+    return static_cast<const RadixInner *>(n)->total;
+}
+
+// ##########################################################
+// @par Name
+// printTree
+// @purpose
+// public access to display every word and its count in
+// alphabetical order
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void RadixTree::printTree() const
+{
+    printTree(this->root);
+}
+
+// ##########################################################
+// @par Name
+// printPrefix
+// @purpose
+// displays every word starting with the passed prefix and
+// its count in alphabetical order
+// @param [in] :
+// const string &prefix - prefix the words must start with
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void RadixTree::printPrefix(const string &prefix) const
+{
+    printTree(findPrefix(prefix));
+}
+
+// ##########################################################
+// @par Name
+// makeEmpty
+// @purpose
+// public access to delete memory from a RadixTree
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void RadixTree::makeEmpty()
+{
+    makeEmpty(this->root);
+    this->numWords = 0;
+}
+
+// ##########################################################
+// @par Name
+// memoryUsage
+// @purpose
+// public access to estimate the bytes held by the tree
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t RadixTree::memoryUsage() const
+{
+    return memoryUsage(this->root);
+}
+
+// ##########################################################
+// @par Name
+// printTree
+// @purpose
+// displays every word below a node and its count
+// @param [in] :
+// const RadixHeader *r - address of node to display from
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void RadixTree::printTree(const RadixHeader *r) const
+{
+    auto print = [](const string &word, uint64_t count)
+    {
+	   cout << word << " - " << count << endl;
+    };
+    visit(r, print);
+}
+
+// ##########################################################
+// @par Name
+// makeEmpty
+// @purpose
+// deletes every node below the passed node
+// @param [in] :
+// RadixHeader *r - address of node where the method deletes
+//			 memory
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void RadixTree::makeEmpty(RadixHeader *&r)
+{
+    if (r == nullptr)
+	   return;
+
+    switch (r->type)
+    {
+    case RADIX_LEAF:
+	   delete static_cast<RadixLeaf *>(r);
+	   break;
+    case RADIX_NODE4:
+    {
+	   RadixNode4 *n = static_cast<RadixNode4 *>(r);
+	   for (int i = 0; i < n->numChildren; i++)
+		  makeEmpty(n->children[i]);
+	   delete n;
+	   break;
+    }
+    case RADIX_NODE16:
+    {
+	   RadixNode16 *n = static_cast<RadixNode16 *>(r);
+	   for (int i = 0; i < n->numChildren; i++)
+		  makeEmpty(n->children[i]);
+	   delete n;
+	   break;
+    }
+    case RADIX_NODE48:
+    {
+	   RadixNode48 *n = static_cast<RadixNode48 *>(r);
+	   for (int i = 0; i < 48; i++)
+		  makeEmpty(n->children[i]);
+	   delete n;
+	   break;
+    }
+    case RADIX_NODE256:
+    {
+	   RadixNode256 *n = static_cast<RadixNode256 *>(r);
+	   for (int c = 0; c < 256; c++)
+		  makeEmpty(n->children[c]);
+	   delete n;
+	   break;
+    }
+    }
+    r = nullptr;
+}
+
+// ##########################################################
+// @par Name
+// clone
+// @purpose
+// copies every node below a node
+// @param [in] :
+// const RadixHeader *r - address of node to copy from
+// @return
+// RadixHeader *
+// @par References
+// None
+// @par Notes
+// recursion is bounded by the longest word, not the word count
+//###########################################################
+RadixHeader *RadixTree::clone(const RadixHeader *r)
+{
+    if (r == nullptr)
+	   return nullptr;
+
+    switch (r->type)
+    {
+    case RADIX_LEAF:
+	   return new RadixLeaf(*static_cast<const RadixLeaf *>(r));
+    case RADIX_NODE4:
+    {
+	   RadixNode4 *n = new RadixNode4(*static_cast<const RadixNode4 *>(r));
+	   for (int i = 0; i < n->numChildren; i++)
+		  n->children[i] = clone(n->children[i]);
+	   return n;
+    }
+    case RADIX_NODE16:
+    {
+	   RadixNode16 *n = new RadixNode16(*static_cast<const RadixNode16 *>(r));
+	   for (int i = 0; i < n->numChildren; i++)
+		  n->children[i] = clone(n->children[i]);
+	   return n;
+    }
+    case RADIX_NODE48:
+    {
+	   RadixNode48 *n = new RadixNode48(*static_cast<const RadixNode48 *>(r));
+	   for (int i = 0; i < 48; i++)
+		  n->children[i] = clone(n->children[i]);
+	   return n;
+    }
+    case RADIX_NODE256:
+    {
+	   RadixNode256 *n = new RadixNode256(*static_cast<const RadixNode256 *>(r));
+	   for (int c = 0; c < 256; c++)
+		  n->children[c] = clone(n->children[c]);
+	   return n;
+    }
+    }
+    return nullptr;
+}
+
+// ##########################################################
+// @par Name
+// memoryUsage
+// @purpose
+// estimates the bytes held by every node below a node
+// @param [in] :
+// const RadixHeader *r - address of node to measure from
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// heap storage of long keys is included, allocator overhead
+// is not
+//###########################################################
+size_t RadixTree::memoryUsage(const RadixHeader *r) const
+{
+    if (r == nullptr)
+	   return 0;
+
+    size_t bytes = 0;
+    switch (r->type)
+    {
+    case RADIX_LEAF:
+    {
+	   const RadixLeaf *l = static_cast<const RadixLeaf *>(r);
+	   bytes = sizeof(RadixLeaf);
+	   if (l->element.capacity() > string().capacity())
+		  bytes += l->element.capacity() + 1;
+	   break;
+    }
+    case RADIX_NODE4:
+    {
+	   const RadixNode4 *n = static_cast<const RadixNode4 *>(r);
+	   bytes = sizeof(RadixNode4);
+	   for (int i = 0; i < n->numChildren; i++)
+		  bytes += memoryUsage(n->children[i]);
+	   break;
+    }
+    case RADIX_NODE16:
+    {
+	   const RadixNode16 *n = static_cast<const RadixNode16 *>(r);
+	   bytes = sizeof(RadixNode16);
+	   for (int i = 0; i < n->numChildren; i++)
+		  bytes += memoryUsage(n->children[i]);
+	   break;
+    }
+    case RADIX_NODE48:
+    {
+	   const RadixNode48 *n = static_cast<const RadixNode48 *>(r);
+	   bytes = sizeof(RadixNode48);
+	   for (int i = 0; i < 48; i++)
+		  bytes += memoryUsage(n->children[i]);
+	   break;
+    }
+    case RADIX_NODE256:
+    {
+	   const RadixNode256 *n = static_cast<const RadixNode256 *>(r);
+	   bytes = sizeof(RadixNode256);
+	   for (int c = 0; c < 256; c++)
+		  bytes += memoryUsage(n->children[c]);
+	   break;
+    }
+    }
+    return bytes;
+}
+
+// ##########################################################
+// @par Name
+// makeLeaf
+// @purpose
+// allocates a leaf for a key
+// @param [in] :
+// const uint8_t *key - key bytes including the null byte
+// size_t len - length of the key including the null byte
+// uint64_t count - starting count of the leaf
+// @return
+// RadixLeaf *
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+RadixLeaf *RadixTree::makeLeaf(const uint8_t *key, size_t len, uint64_t count)
+{
+    RadixLeaf *l = new RadixLeaf;
+    l->type = RADIX_LEAF;
+    l->wordCount = count;
+    l->element.assign(reinterpret_cast<const char *>(key), len - 1);
+    this->numWords++;
+    return l;
+}
+
+// ##########################################################
+// @par Name
+// insert
+// @purpose
+// adds count occurrences of a key below a node, splitting
+// compressed paths and growing nodes as needed
+// @param [in] :
+// RadixHeader *&r - slot of the node to insert below
+// const uint8_t *key - key bytes including the null byte
+// size_t len - length of the key including the null byte
+// size_t depth - number of key bytes already consumed
+// uint64_t count - number of occurrences to add
+// @return
+// RadixLeaf * - leaf holding the key
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+RadixLeaf *RadixTree::insert(RadixHeader *&r, const uint8_t *key, size_t len, size_t depth, uint64_t count)
+{
+    if (r == nullptr)
+    {
+	   RadixLeaf *l = makeLeaf(key, len, count);
+	   r = l;
+	   return l;
+    }
+
+    if (r->type == RADIX_LEAF)
+    {
+	   RadixLeaf *l = static_cast<RadixLeaf *>(r);
+	   if (leafMatches(l, key, len))
+	   {
+		  l->wordCount += count;
+		  return l;
+	   }
+
+	   // two distinct keys share this slot, split into a Node4
+	   const uint8_t *other = reinterpret_cast<const uint8_t *>(l->element.c_str());
+	   size_t common = 0;
+	   while (other[depth + common] == key[depth + common])
+		  common++;
+
+	   RadixNode4 *n = new RadixNode4{};
+	   n->type = RADIX_NODE4;
+	   n->prefixLen = static_cast<uint32_t>(common);
+	   memcpy(n->prefix, key + depth, common < RADIX_MAX_PREFIX ? common : RADIX_MAX_PREFIX);
+	   n->total = l->wordCount + count;
+
+	   RadixLeaf *added = makeLeaf(key, len, count);
+	   RadixHeader *slot = n;
+	   addChild(slot, other[depth + common], l);
+	   addChild(slot, key[depth + common], added);
+	   r = slot;
+	   return added;
+    }
+
+    RadixInner *inner = static_cast<RadixInner *>(r);
+    if (inner->prefixLen)
+    {
+	   size_t diff = prefixMismatch(inner, key, len, depth);
+	   if (diff < inner->prefixLen)
+	   {
+		  // the key leaves the compressed path, split it at diff
+		  RadixNode4 *n = new RadixNode4{};
+		  n->type = RADIX_NODE4;
+		  n->prefixLen = static_cast<uint32_t>(diff);
+		  memcpy(n->prefix, inner->prefix, diff < RADIX_MAX_PREFIX ? diff : RADIX_MAX_PREFIX);
+		  n->total = inner->total + count;
+
+		  RadixHeader *slot = n;
+		  if (inner->prefixLen <= RADIX_MAX_PREFIX)
+		  {
+			 addChild(slot, inner->prefix[diff], inner);
+			 inner->prefixLen -= static_cast<uint32_t>(diff + 1);
+			 memmove(inner->prefix, inner->prefix + diff + 1,
+					inner->prefixLen < RADIX_MAX_PREFIX ? inner->prefixLen : RADIX_MAX_PREFIX);
+		  }
+		  else
+		  {
+			 inner->prefixLen -= static_cast<uint32_t>(diff + 1);
+			 const uint8_t *minKey = reinterpret_cast<const uint8_t *>(minimum(inner)->element.c_str());
+			 addChild(slot, minKey[depth + diff], inner);
+			 memcpy(inner->prefix, minKey + depth + diff + 1,
+				   inner->prefixLen < RADIX_MAX_PREFIX ? inner->prefixLen : RADIX_MAX_PREFIX);
+		  }
+
+		  RadixLeaf *added = makeLeaf(key, len, count);
+		  addChild(slot, key[depth + diff], added);
+		  r = slot;
+		  return added;
+	   }
+	   depth += inner->prefixLen;
+    }
+
+    inner->total += count;
+    RadixHeader **child = findChild(r, key[depth]);
+    if (child != nullptr)
+	   return insert(*child, key, len, depth + 1, count);
+
+    RadixLeaf *added = makeLeaf(key, len, count);
+    addChild(r, key[depth], added);
+    return added;
+}
+
+// ##########################################################
+// @par Name
+// find
+// @purpose
+// finds the leaf holding a word
+// @param [in] :
+// const string &data - word to be searched for
+// @return
+// const RadixLeaf * - nullptr when the word is not found
+// @par References
+// None
+// @par Notes
+// compressed paths are skipped optimistically and the leaf
+// key is compared in full at the end
+//###########################################################
+const RadixLeaf *RadixTree::find(const string &data) const
+{
+    const uint8_t *key = reinterpret_cast<const uint8_t *>(data.c_str());
+    size_t len = data.size() + 1;
+    size_t depth = 0;
+    RadixHeader *n = this->root;
+
+    while (n != nullptr)
+    {
+	   if (n->type == RADIX_LEAF)
+	   {
+		  const RadixLeaf *l = static_cast<const RadixLeaf *>(n);
+		  return leafMatches(l, key, len) ? l : nullptr;
+	   }
+
+	   const RadixInner *inner = static_cast<const RadixInner *>(n);
+	   if (inner->prefixLen)
+	   {
+		  size_t stored = inner->prefixLen < RADIX_MAX_PREFIX ? inner->prefixLen : RADIX_MAX_PREFIX;
+		  if (depth + stored > len || memcmp(inner->prefix, key + depth, stored) != 0)
+			 return nullptr;
+		  depth += inner->prefixLen;
+	   }
+	   if (depth >= len)
+		  return nullptr;
+
+	   RadixHeader **child = findChild(n, key[depth]);
+	   n = child == nullptr ? nullptr : *child;
+	   depth++;
+    }
+    return nullptr;
+}
+
+// ##########################################################
+// @par Name
+// findPrefix
+// @purpose
+// finds the highest node whose subtree holds exactly the
+// words starting with the passed prefix
+// @param [in] :
+// const string &prefix - prefix the words must start with
+// @return
+// const RadixHeader * - nullptr when no word has the prefix
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+const RadixHeader *RadixTree::findPrefix(const string &prefix) const
+{
+    const uint8_t *key = reinterpret_cast<const uint8_t *>(prefix.data());
+    size_t len = prefix.size();
+    size_t depth = 0;
+    RadixHeader *n = this->root;
+
+    while (n != nullptr)
+    {
+	   if (n->type == RADIX_LEAF)
+	   {
+		  const RadixLeaf *l = static_cast<const RadixLeaf *>(n);
+		  return l->element.compare(0, len, prefix) == 0 ? l : nullptr;
+	   }
+	   if (depth == len)
+		  return n;
+
+	   const RadixInner *inner = static_cast<const RadixInner *>(n);
+	   if (inner->prefixLen)
+	   {
+		  size_t matched = prefixMismatch(inner, key, len, depth);
+		  if (matched > inner->prefixLen)
+			 matched = inner->prefixLen;
+		  if (depth + matched == len)
+			 return n;
+		  if (matched < inner->prefixLen)
+			 return nullptr;
+		  depth += inner->prefixLen;
+	   }
+
+	   RadixHeader **child = findChild(n, key[depth]);
+	   n = child == nullptr ? nullptr : *child;
+	   depth++;
+    }
+    return nullptr;
+}
+
+// ##########################################################
+// @par Name
+// findChild
+// @purpose
+// finds the child slot of a node for a key byte
+// @param [in] :
+// RadixHeader *n - inner node to search
+// uint8_t c - key byte of the child
+// @return
+// RadixHeader ** - nullptr when the node has no such child
+// @par References
+// None
+// @par Notes
+// Node16 keys are compared sixteen at a time when SSE2 is
+// available
+//###########################################################
+RadixHeader **RadixTree::findChild(RadixHeader *n, uint8_t c)
+{
+    switch (n->type)
+    {
+    case RADIX_NODE4:
+    {
+	   RadixNode4 *p = static_cast<RadixNode4 *>(n);
+	   for (int i = 0; i < p->numChildren; i++)
+		  if (p->keys[i] == c)
+			 return &p->children[i];
+	   break;
+    }
+    case RADIX_NODE16:
+    {
+	   RadixNode16 *p = static_cast<RadixNode16 *>(n);
+#ifdef __SSE2__
+	   __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(c)),
+								 _mm_loadu_si128(reinterpret_cast<const __m128i *>(p->keys)));
+	   unsigned bits = static_cast<unsigned>(_mm_movemask_epi8(cmp)) & ((1u << p->numChildren) - 1);
+	   if (bits)
+		  return &p->children[__builtin_ctz(bits)];
+#else
+	   for (int i = 0; i < p->numChildren; i++)
+		  if (p->keys[i] == c)
+			 return &p->children[i];
+#endif
+	   break;
+    }
+    case RADIX_NODE48:
+    {
+	   RadixNode48 *p = static_cast<RadixNode48 *>(n);
+	   if (p->childIndex[c])
+		  return &p->children[p->childIndex[c] - 1];
+	   break;
+    }
+    case RADIX_NODE256:
+    {
+	   RadixNode256 *p = static_cast<RadixNode256 *>(n);
+	   if (p->children[c] != nullptr)
+		  return &p->children[c];
+	   break;
+    }
+    default:
+	   break;
+    }
+    return nullptr;
+}
+
+// ##########################################################
+// @par Name
+// minimum
+// @purpose
+// finds the alphabetically smallest leaf below a node
+// @param [in] :
+// const RadixHeader *n - address of node to search from
+// @return
+// const RadixLeaf *
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+const RadixLeaf *RadixTree::minimum(const RadixHeader *n)
+{
+    while (n != nullptr && n->type != RADIX_LEAF)
+    {
+	   switch (n->type)
+	   {
+	   case RADIX_NODE4:
+		  n = static_cast<const RadixNode4 *>(n)->children[0];
+		  break;
+	   case RADIX_NODE16:
+		  n = static_cast<const RadixNode16 *>(n)->children[0];
+		  break;
+	   case RADIX_NODE48:
+	   {
+		  const RadixNode48 *p = static_cast<const RadixNode48 *>(n);
+		  int c = 0;
+		  while (!p->childIndex[c])
+			 c++;
+		  n = p->children[p->childIndex[c] - 1];
+		  break;
+	   }
+	   case RADIX_NODE256:
+	   {
+		  const RadixNode256 *p = static_cast<const RadixNode256 *>(n);
+		  int c = 0;
+		  while (p->children[c] == nullptr)
+			 c++;
+		  n = p->children[c];
+		  break;
+	   }
+	   default:
+		  break;
+	   }
+    }
+    return static_cast<const RadixLeaf *>(n);
+}
+
+// ##########################################################
+// @par Name
+// leafMatches
+// @purpose
+// determines if a leaf holds exactly the passed key
+// @param [in] :
+// const RadixLeaf *l - leaf to compare
+// const uint8_t *key - key bytes including the null byte
+// size_t len - length of the key including the null byte
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool RadixTree::leafMatches(const RadixLeaf *l, const uint8_t *key, size_t len)
+{
+    return l->element.size() + 1 == len && memcmp(l->element.data(), key, len - 1) == 0;
+}
+
+// ##########################################################
+// @par Name
+// prefixMismatch
+// @purpose
+// counts how many bytes of a node's compressed path match
+// the key starting at depth
+// @param [in] :
+// const RadixInner *n - node whose path is compared
+// const uint8_t *key - key bytes
+// size_t len - number of key bytes
+// size_t depth - number of key bytes already consumed
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// bytes past RADIX_MAX_PREFIX are read from the smallest leaf
+// below the node
+//###########################################################
+size_t RadixTree::prefixMismatch(const RadixInner *n, const uint8_t *key, size_t len, size_t depth)
+{
+    size_t stored = n->prefixLen < RADIX_MAX_PREFIX ? n->prefixLen : RADIX_MAX_PREFIX;
+    size_t maxCmp = len - depth < stored ? len - depth : stored;
+    size_t idx = 0;
+    for (; idx < maxCmp; idx++)
+	   if (n->prefix[idx] != key[depth + idx])
+		  return idx;
+
+    if (n->prefixLen > RADIX_MAX_PREFIX && idx == stored)
+    {
+	   const string &minKey = minimum(n)->element;
+	   const uint8_t *other = reinterpret_cast<const uint8_t *>(minKey.c_str());
+	   size_t limit = (minKey.size() + 1 < len ? minKey.size() + 1 : len) - depth;
+	   if (limit > n->prefixLen)
+		  limit = n->prefixLen;
+	   for (; idx < limit; idx++)
+		  if (other[depth + idx] != key[depth + idx])
+			 return idx;
+    }
+    return idx;
+}
+
+// ##########################################################
+// @par Name
+// copyHeader
+// @purpose
+// copies the shared inner node fields when a node grows
+// @param [in] :
+// RadixInner *dest - node being filled
+// const RadixInner *src - node being replaced
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void RadixTree::copyHeader(RadixInner *dest, const RadixInner *src)
+{
+    dest->numChildren = src->numChildren;
+    dest->prefixLen = src->prefixLen;
+    memcpy(dest->prefix, src->prefix, RADIX_MAX_PREFIX);
+    dest->total = src->total;
+}
+
+// ##########################################################
+// @par Name
+// addChild
+// @purpose
+// adds a child to an inner node, replacing the node with the
+// next larger node type when it is full
+// @param [in] :
+// RadixHeader *&r - slot of the node receiving the child
+// uint8_t c - key byte of the child
+// RadixHeader *child - child to add
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// Node4 and Node16 keep their keys sorted so traversal stays
+// in alphabetical order
+//###########################################################
+void RadixTree::addChild(RadixHeader *&r, uint8_t c, RadixHeader *child)
+{
+    switch (r->type)
+    {
+    case RADIX_NODE4:
+    {
+	   RadixNode4 *n = static_cast<RadixNode4 *>(r);
+	   if (n->numChildren < 4)
+	   {
+		  int i = 0;
+		  while (i < n->numChildren && n->keys[i] < c)
+			 i++;
+		  memmove(n->keys + i + 1, n->keys + i, n->numChildren - i);
+		  memmove(n->children + i + 1, n->children + i, (n->numChildren - i) * sizeof(RadixHeader *));
+		  n->keys[i] = c;
+		  n->children[i] = child;
+		  n->numChildren++;
+		  return;
+	   }
+	   RadixNode16 *bigger = new RadixNode16{};
+	   bigger->type = RADIX_NODE16;
+	   copyHeader(bigger, n);
+	   memcpy(bigger->keys, n->keys, sizeof(n->keys));
+	   memcpy(bigger->children, n->children, sizeof(n->children));
+	   delete n;
+	   r = bigger;
+	   addChild(r, c, child);
+	   return;
+    }
+    case RADIX_NODE16:
+    {
+	   RadixNode16 *n = static_cast<RadixNode16 *>(r);
+	   if (n->numChildren < 16)
+	   {
+		  int i = 0;
+		  while (i < n->numChildren && n->keys[i] < c)
+			 i++;
+		  memmove(n->keys + i + 1, n->keys + i, n->numChildren - i);
+		  memmove(n->children + i + 1, n->children + i, (n->numChildren - i) * sizeof(RadixHeader *));
+		  n->keys[i] = c;
+		  n->children[i] = child;
+		  n->numChildren++;
+		  return;
+	   }
+	   RadixNode48 *bigger = new RadixNode48{};
+	   bigger->type = RADIX_NODE48;
+	   copyHeader(bigger, n);
+	   for (int i = 0; i < 16; i++)
+	   {
+		  bigger->children[i] = n->children[i];
+		  bigger->childIndex[n->keys[i]] = static_cast<uint8_t>(i + 1);
+	   }
+	   delete n;
+	   r = bigger;
+	   addChild(r, c, child);
+	   return;
+    }
+    case RADIX_NODE48:
+    {
+	   RadixNode48 *n = static_cast<RadixNode48 *>(r);
+	   if (n->numChildren < 48)
+	   {
+		  int pos = 0;
+		  while (n->children[pos] != nullptr)
+			 pos++;
+		  n->children[pos] = child;
+		  n->childIndex[c] = static_cast<uint8_t>(pos + 1);
+		  n->numChildren++;
+		  return;
+	   }
+	   RadixNode256 *bigger = new RadixNode256{};
+	   bigger->type = RADIX_NODE256;
+	   copyHeader(bigger, n);
+	   for (int i = 0; i < 256; i++)
+		  if (n->childIndex[i])
+			 bigger->children[i] = n->children[n->childIndex[i] - 1];
+	   delete n;
+	   r = bigger;
+	   addChild(r, c, child);
+	   return;
+    }
+    case RADIX_NODE256:
+    {
+	   RadixNode256 *n = static_cast<RadixNode256 *>(r);
+	   n->numChildren++;
+	   n->children[c] = child;
+	   return;
+    }
+    default:
+	   return;
+    }
+}
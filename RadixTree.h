@@ -0,0 +1,231 @@
+//##########################################################
+// File: RadixTree.h
+// Description: This file contains the node structures and
+//			 class definition for RadixTree, an adaptive
+//			 radix tree (ART) that counts words
+//##########################################################
+
+#ifndef RADIX_TREE_H
+#define RADIX_TREE_H
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+using std::string;
+
+// compressed path bytes kept inline in each inner node; longer
+// paths are checked against a leaf below the node
+const unsigned RADIX_MAX_PREFIX = 10;
+
+enum RadixNodeType : uint8_t
+{
+    RADIX_LEAF,
+    RADIX_NODE4,
+    RADIX_NODE16,
+    RADIX_NODE48,
+    RADIX_NODE256
+};
+
+struct RadixHeader
+{
+    RadixNodeType type;
+};
+
+struct RadixLeaf : RadixHeader
+{
+    uint64_t wordCount;
+    string element;
+};
+
+struct RadixInner : RadixHeader
+{
+    uint16_t numChildren;
+    uint32_t prefixLen;
+    uint8_t prefix[RADIX_MAX_PREFIX];
+    uint64_t total;
+};
+
+struct RadixNode4 : RadixInner
+{
+    uint8_t keys[4];
+    RadixHeader *children[4];
+};
+
+struct RadixNode16 : RadixInner
+{
+    uint8_t keys[16];
+    RadixHeader *children[16];
+};
+
+struct RadixNode48 : RadixInner
+{
+    uint8_t childIndex[256];
+    RadixHeader *children[48];
+};
+
+struct RadixNode256 : RadixInner
+{
+    RadixHeader *children[256];
+};
+
+class RadixTree
+{
+private:
+    RadixHeader *root{};
+    size_t numWords{};
+
+    RadixLeaf *insert(RadixHeader *&r, const uint8_t *key, size_t len, size_t depth, uint64_t count);
+    void printTree(const RadixHeader *r) const;
+    void makeEmpty(RadixHeader *&r);
+    static RadixHeader *clone(const RadixHeader *r);
+    size_t memoryUsage(const RadixHeader *r) const;
+
+    RadixLeaf *makeLeaf(const uint8_t *key, size_t len, uint64_t count);
+    const RadixLeaf *find(const string &data) const;
+    const RadixHeader *findPrefix(const string &prefix) const;
+
+    // NODE MANIPULATIONS
+    static RadixHeader **findChild(RadixHeader *n, uint8_t c);
+    static const RadixLeaf *minimum(const RadixHeader *n);
+    static bool leafMatches(const RadixLeaf *l, const uint8_t *key, size_t len);
+    static size_t prefixMismatch(const RadixInner *n, const uint8_t *key, size_t len, size_t depth);
+    static void copyHeader(RadixInner *dest, const RadixInner *src);
+    static void addChild(RadixHeader *&r, uint8_t c, RadixHeader *child);
+
+    template<class Visitor>
+    static void visit(const RadixHeader *r, Visitor &visitor);
+
+public:
+    RadixTree();
+    RadixTree(const RadixTree &tree);
+    RadixTree(RadixTree &&tree) noexcept;
+    RadixTree &operator=(const RadixTree &tree);
+    RadixTree &operator=(RadixTree &&tree) noexcept;
+    void swap(RadixTree &tree) noexcept;
+
+    bool isEmpty() const;
+    bool contains(const string &data) const;
+    size_t size() const;
+    size_t memoryUsage() const;
+
+    void insert(const string &data, uint64_t count = 1);
+    uint64_t count(const string &data) const;
+    uint64_t prefixCount(const string &prefix) const;
+    void printTree() const;
+    void printPrefix(const string &prefix) const;
+    void makeEmpty();
+
+    template<class Visitor>
+    void forEach(Visitor visitor) const;
+    template<class Visitor>
+    void forEachPrefix(const string &prefix, Visitor visitor) const;
+
+    ~RadixTree();
+};
+
+// ##########################################################
+// @par Name
+// visit
+// @purpose
+// calls the visitor on every leaf below a node in
+// lexicographic order
+// @param [in] :
+// const RadixHeader *r - address of node to visit from
+// Visitor &visitor - callable taking (const string &, uint64_t)
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class Visitor>
+void RadixTree::visit(const RadixHeader *r, Visitor &visitor)
+{
+    if (r == nullptr)
+	   return;
+
+    switch (r->type)
+    {
+    case RADIX_LEAF:
+    {
+	   const RadixLeaf *l = static_cast<const RadixLeaf *>(r);
+	   visitor(l->element, l->wordCount);
+	   break;
+    }
+    case RADIX_NODE4:
+    {
+	   const RadixNode4 *n = static_cast<const RadixNode4 *>(r);
+	   for (int i = 0; i < n->numChildren; i++)
+		  visit(n->children[i], visitor);
+	   break;
+    }
+    case RADIX_NODE16:
+    {
+	   const RadixNode16 *n = static_cast<const RadixNode16 *>(r);
+	   for (int i = 0; i < n->numChildren; i++)
+		  visit(n->children[i], visitor);
+	   break;
+    }
+    case RADIX_NODE48:
+    {
+	   const RadixNode48 *n = static_cast<const RadixNode48 *>(r);
+	   for (int c = 0; c < 256; c++)
+		  if (n->childIndex[c])
+			 visit(n->children[n->childIndex[c] - 1], visitor);
+	   break;
+    }
+    case RADIX_NODE256:
+    {
+	   const RadixNode256 *n = static_cast<const RadixNode256 *>(r);
+	   for (int c = 0; c < 256; c++)
+		  visit(n->children[c], visitor);
+	   break;
+    }
+    }
+}
+
+// ##########################################################
+// @par Name
+// forEach
+// @purpose
+// calls the visitor on every word and its count in
+// lexicographic order
+// @param [in] :
+// Visitor visitor - callable taking (const string &, uint64_t)
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class Visitor>
+void RadixTree::forEach(Visitor visitor) const
+{
+    visit(this->root, visitor);
+}
+
+// ##########################################################
+// @par Name
+// forEachPrefix
+// @purpose
+// calls the visitor on every word starting with the passed
+// prefix in lexicographic order
+// @param [in] :
+// const string &prefix - prefix the words must start with
+// Visitor visitor - callable taking (const string &, uint64_t)
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// only the subtree below the prefix is walked
+//###########################################################
+template<class Visitor>
+void RadixTree::forEachPrefix(const string &prefix, Visitor visitor) const
+{
+    visit(findPrefix(prefix), visitor);
+}
+
+#endif
@@ -0,0 +1,389 @@
+//##########################################################
+// File: SampleEstimator.cpp
+// Description: This file contains the class implementation
+//			 for SampleEstimator
+//##########################################################
+
+#include "SampleEstimator.h"
+#include "Decompressor.h"
+#include "Tokenizer.h"
+#include <algorithm>
+#include <cmath>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::cout;
+using std::endl;
+
+// ##########################################################
+// @par Name
+// SampleEstimator
+// @purpose
+// creates an estimator for a file cut into a number of chunks
+// @param [in] :
+// uint64_t chunks - chunks in the whole file
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+SampleEstimator::SampleEstimator(uint64_t chunks) : population(chunks), sampled(0), tokenTally{0, 0} {}
+
+// ##########################################################
+// @par Name
+// addChunk
+// @purpose
+// adds the word counts of one sampled chunk
+// @param [in] :
+// const std::unordered_map<string, uint64_t, WordHash> &counts -
+//		 words of the chunk and how many times each appeared
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// only the sum and the sum of squares of each word's per chunk
+// count are kept, which is all the variance needs; a chunk
+// without the word adds 0 to both
+//###########################################################
+void SampleEstimator::addChunk(const std::unordered_map<string, uint64_t, WordHash> &counts)
+{
+    uint64_t total = 0;
+    for (const auto &entry : counts)
+    {
+	   Tally &t = this->tallies[entry.first];
+	   t.sum += entry.second;
+	   t.sumSquares += entry.second * entry.second;
+	   total += entry.second;
+    }
+    this->tokenTally.sum += total;
+    this->tokenTally.sumSquares += total * total;
+    this->sampled++;
+}
+
+// ##########################################################
+// @par Name
+// scale
+// @purpose
+// extrapolates per chunk counts to the whole file
+// @param [in] :
+// const Tally &t - sum and sum of squares over the sample
+// @return
+// Estimate
+// @par References
+// Cochran, Sampling Techniques, expansion estimator of a total
+// @par Notes
+// one chunk is drawn from each of the equal strata; the simple
+// random sample variance is used for it, which can only
+// overstate the variance of a stratified sample of a file
+// whose text changes slowly from chunk to chunk. The finite
+// population correction makes a full sample exact
+//###########################################################
+Estimate SampleEstimator::scale(const Tally &t) const
+{
+    double n = static_cast<double>(this->sampled);
+    double N = static_cast<double>(this->population);
+    if (this->sampled == 0)
+	   return Estimate{0, 0};
+
+    double mean = t.sum / n;
+    double variance = 0;
+    if (this->sampled > 1)
+    {
+	   double spread = (static_cast<double>(t.sumSquares) - t.sum * mean) / (n - 1);
+	   variance = N * N * (1 - n / N) * std::max(spread, 0.0) / n;
+    }
+    return Estimate{N * mean, SAMPLE_Z * std::sqrt(variance)};
+}
+
+// ##########################################################
+// @par Name
+// tokens
+// @purpose
+// estimates the number of words in the whole file
+// @param [in] :
+// None
+// @return
+// Estimate
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+Estimate SampleEstimator::tokens() const
+{
+    return scale(this->tokenTally);
+}
+
+// ##########################################################
+// @par Name
+// count
+// @purpose
+// estimates how many times a word appears in the whole file
+// @param [in] :
+// const string &word - word to be estimated
+// @return
+// Estimate
+// @par References
+// None
+// @par Notes
+// a word missing from the sample gets 0 with no interval;
+// rare words are the ones a sample says least about
+//###########################################################
+Estimate SampleEstimator::count(const string &word) const
+{
+    auto it = this->tallies.find(word);
+    return it == this->tallies.end() ? Estimate{0, 0} : scale(it->second);
+}
+
+// ##########################################################
+// @par Name
+// vocabulary
+// @purpose
+// estimates the number of distinct words in the whole file
+// @param [in] :
+// None
+// @return
+// VocabularyEstimate
+// @par References
+// Chao, "Nonparametric estimation of the number of classes in
+// a population" (1984), with its log-normal interval
+// @par Notes
+// built from the words seen once and twice in the sample.
+// Words cluster in chunks, so the estimate leans low on a
+// small sample; it is still far closer than the observed count.
+// A sample of every chunk has seen every word
+//###########################################################
+VocabularyEstimate SampleEstimator::vocabulary() const
+{
+    double f1 = 0;
+    double f2 = 0;
+    for (const auto &entry : this->tallies)
+    {
+	   if (entry.second.sum == 1)
+		  f1++;
+	   else if (entry.second.sum == 2)
+		  f2++;
+    }
+
+    VocabularyEstimate v;
+    v.observed = this->tallies.size();
+    double unseen = f2 > 0 ? f1 * f1 / (2 * f2) : f1 * (f1 - 1) / 2;
+    if (this->sampled >= this->population)
+	   unseen = 0;
+    v.value = v.observed + unseen;
+    double variance;
+    if (f2 > 0)
+    {
+	   double r = f1 / f2;
+	   variance = f2 * (r * r / 2 + r * r * r + r * r * r * r / 4);
+    }
+    else
+	   variance = f1 * (f1 - 1) / 2 + f1 * (2 * f1 - 1) * (2 * f1 - 1) / 4 - f1 * f1 * f1 * f1 / (4 * v.value);
+
+    if (unseen <= 0 || this->sampled >= this->population)
+    {
+	   v.low = v.high = v.value;
+	   return v;
+    }
+    double k = std::exp(SAMPLE_Z * std::sqrt(std::log(1 + std::max(variance, 0.0) / (unseen * unseen))));
+    v.low = v.observed + unseen / k;
+    v.high = v.observed + unseen * k;
+    return v;
+}
+
+// ##########################################################
+// @par Name
+// top
+// @purpose
+// gets the words with the largest estimated counts
+// @param [in] :
+// size_t k - most words to return, 0 for all of them
+// @return
+// vector<std::pair<string, Estimate>> - most frequent first,
+//								 ties alphabetically
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+vector<std::pair<string, Estimate>> SampleEstimator::top(size_t k) const
+{
+    vector<std::pair<string, Estimate>> result;
+    result.reserve(this->tallies.size());
+    for (const auto &entry : this->tallies)
+	   result.push_back({entry.first, scale(entry.second)});
+
+    auto order = [](const std::pair<string, Estimate> &a, const std::pair<string, Estimate> &b)
+    {
+	   return a.second.value != b.second.value ? a.second.value > b.second.value : a.first < b.first;
+    };
+    if (k != 0 && k < result.size())
+    {
+	   std::partial_sort(result.begin(), result.begin() + k, result.end(), order);
+	   result.resize(k);
+    }
+    else
+	   std::sort(result.begin(), result.end(), order);
+    return result;
+}
+
+// ##########################################################
+// @par Name
+// chunksSampled
+// @purpose
+// gets the number of chunks added so far
+// @param [in] :
+// None
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t SampleEstimator::chunksSampled() const
+{
+    return this->sampled;
+}
+
+// ##########################################################
+// @par Name
+// readAt
+// @purpose
+// reads bytes from a position of a file
+// @param [in] :
+// int fd - open file
+// char *dest - where the bytes are stored
+// size_t len - bytes wanted
+// uint64_t offset - position of the first byte
+// @return
+// size_t - bytes read, fewer at the end of the file or on an
+//		    error
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+static size_t readAt(int fd, char *dest, size_t len, uint64_t offset)
+{
+    size_t total = 0;
+    while (total < len)
+    {
+	   ssize_t n = pread(fd, dest + total, len - total, static_cast<off_t>(offset + total));
+	   if (n <= 0)
+		  break;
+	   total += static_cast<size_t>(n);
+    }
+    return total;
+}
+
+// ##########################################################
+// @par Name
+// estimateSampled
+// @purpose
+// estimates the word counts of a file from a stratified
+// sample of its chunks and displays them
+// @param [in] :
+// const string &filename - file to be sampled
+// double fraction - share of the chunks to read, in (0, 1]
+// size_t limit - most words to display, 0 for all of them
+// uint64_t seed - seed of the random chunk choice
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the file is cut into as many equal strata as chunks are
+// wanted and one aligned chunk is read from a random place in
+// each, in file order. A word belongs to the chunk it starts
+// in: the word cut off at the start of a chunk is skipped and
+// the one running off its end is finished from the next bytes,
+// so no word is counted twice. Needs a seekable uncompressed
+// file
+//###########################################################
+void estimateSampled(const string &filename, double fraction, size_t limit, uint64_t seed)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+    {
+	   if (fd >= 0)
+		  close(fd);
+	   cout << "Sampling needs a regular file" << endl;
+	   return;
+    }
+    unsigned char magic[4];
+    if (Decompressor::detect(magic, readAt(fd, reinterpret_cast<char *>(magic), sizeof(magic), 0)) != NO_COMPRESSION)
+    {
+	   close(fd);
+	   cout << "Sampling needs an uncompressed file" << endl;
+	   return;
+    }
+
+    uint64_t size = static_cast<uint64_t>(info.st_size);
+    uint64_t chunks = (size + SAMPLE_CHUNK_SIZE - 1) / SAMPLE_CHUNK_SIZE;
+    uint64_t wanted = static_cast<uint64_t>(std::ceil(std::min(std::max(fraction, 0.0), 1.0) * chunks));
+    wanted = std::min(chunks, std::max<uint64_t>(wanted, 2));
+
+    SampleEstimator estimator(chunks);
+    std::mt19937_64 random(seed);
+    const CharClass *classes = Tokenizer::classes();
+    vector<char> buffer(1 + SAMPLE_CHUNK_SIZE + SAMPLE_TAIL);
+    std::unordered_map<string, uint64_t, WordHash> counts;
+    uint64_t bytesRead = 0;
+
+    for (uint64_t s = 0; s < wanted; s++)
+    {
+	   uint64_t first = chunks * s / wanted;
+	   uint64_t last = chunks * (s + 1) / wanted;
+	   uint64_t chunk = first + random() % (last - first);
+
+	   // one byte before the chunk tells if it starts mid word
+	   uint64_t offset = chunk * SAMPLE_CHUNK_SIZE;
+	   uint64_t from = offset > 0 ? offset - 1 : 0;
+	   size_t core = (offset - from) + SAMPLE_CHUNK_SIZE;
+	   size_t got = readAt(fd, buffer.data(), core, from);
+	   bytesRead += got;
+
+	   size_t begin = 0;
+	   if (offset > 0)
+		  while (begin < got && classes[static_cast<uint8_t>(buffer[begin])] != SEPARATOR)
+			 begin++;
+	   size_t end = got;
+	   if (got == core && end > begin && classes[static_cast<uint8_t>(buffer[end - 1])] != SEPARATOR)
+	   {
+		  // the last word runs into the next chunk
+		  size_t tail = readAt(fd, buffer.data() + got, SAMPLE_TAIL, from + got);
+		  bytesRead += tail;
+		  got += tail;
+		  while (end < got && classes[static_cast<uint8_t>(buffer[end])] != SEPARATOR)
+			 end++;
+	   }
+
+	   counts.clear();
+	   Tokenizer tokenizer;
+	   auto add = [&counts](const string &word) { counts[word]++; };
+	   if (begin < end)
+		  tokenizer.feed(buffer.data() + begin, end - begin, add);
+	   tokenizer.finish(add);
+	   estimator.addChunk(counts);
+    }
+    close(fd);
+
+    Estimate tokens = estimator.tokens();
+    VocabularyEstimate vocab = estimator.vocabulary();
+    cout << std::fixed << std::setprecision(0);
+    cout << "sampled chunks - " << estimator.chunksSampled() << " of " << chunks << " (" << bytesRead << " of " << size << " bytes)" << endl;
+    cout << "words - " << tokens.value << " +/- " << tokens.margin << endl;
+    cout << "distinct words (chao1, a lower bound) - " << vocab.value << " (" << vocab.low << " to " << vocab.high << "), " << vocab.observed << " seen" << endl;
+    for (const auto &entry : estimator.top(limit))
+	   cout << entry.first << " - " << entry.second.value << " +/- " << entry.second.margin << endl;
+    cout << std::defaultfloat;
+}
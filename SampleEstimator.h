@@ -0,0 +1,75 @@
+//##########################################################
+// File: SampleEstimator.h
+// Description: This file contains the class definition for
+//			 SampleEstimator, which extrapolates the counts
+//			 of a whole file from a sample of its chunks
+//##########################################################
+
+#ifndef SAMPLE_ESTIMATOR_H
+#define SAMPLE_ESTIMATOR_H
+#include "NGramCount.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+// bytes in one sampled chunk; chunks start at multiples of it
+const size_t SAMPLE_CHUNK_SIZE = 64 << 10;
+// bytes read past a chunk to finish the word running off its end
+const size_t SAMPLE_TAIL = 4096;
+// normal quantile of the 95% confidence intervals
+const double SAMPLE_Z = 1.96;
+
+// an estimated total and the half width of its 95% interval
+struct Estimate
+{
+    double value;
+    double margin;
+};
+
+// Chao1 estimate of the number of distinct words and its 95%
+// interval
+struct VocabularyEstimate
+{
+    uint64_t observed;
+    double value;
+    double low;
+    double high;
+};
+
+class SampleEstimator
+{
+private:
+    struct Tally
+    {
+	   uint64_t sum;
+	   uint64_t sumSquares;
+    };
+
+    std::unordered_map<string, Tally, WordHash> tallies;
+    uint64_t population;
+    uint64_t sampled;
+    Tally tokenTally;
+
+    Estimate scale(const Tally &t) const;
+
+public:
+    explicit SampleEstimator(uint64_t chunks);
+
+    void addChunk(const std::unordered_map<string, uint64_t, WordHash> &counts);
+
+    Estimate tokens() const;
+    Estimate count(const string &word) const;
+    VocabularyEstimate vocabulary() const;
+    vector<std::pair<string, Estimate>> top(size_t k) const;
+    uint64_t chunksSampled() const;
+};
+
+void estimateSampled(const string &filename, double fraction, size_t limit, uint64_t seed);
+
+#endif
@@ -0,0 +1,798 @@
+//##########################################################
+// File: Server.cpp
+// Description: This file contains the class implementation
+//			 for WordCountServer
+//##########################################################
+
+#include "Server.h"
+#include "CountFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// ##########################################################
+// @par Name
+// putU32
+// @purpose
+// appends a little endian 32 bit integer
+// @param [in] :
+// uint32_t value - integer to append
+// @return
+// None
+// @par References
+// std::vector<char> &out - buffer being written
+// @par Notes
+// None
+//###########################################################
+static void putU32(std::vector<char> &out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+	   out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+// ##########################################################
+// @par Name
+// putU64
+// @purpose
+// appends a little endian 64 bit integer
+// @param [in] :
+// uint64_t value - integer to append
+// @return
+// None
+// @par References
+// std::vector<char> &out - buffer being written
+// @par Notes
+// None
+//###########################################################
+static void putU64(std::vector<char> &out, uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+	   out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+// ##########################################################
+// @par Name
+// getU32
+// @purpose
+// reads a little endian 32 bit integer
+// @param [in] :
+// const char *data - first of the four bytes
+// @return
+// uint32_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+static uint32_t getU32(const char *data)
+{
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--)
+	   value = (value << 8) | static_cast<unsigned char>(data[i]);
+    return value;
+}
+
+// ##########################################################
+// @par Name
+// hasRequest
+// @purpose
+// checks whether a client's input starts with a whole request
+// @param [in] :
+// const std::vector<char> &in - bytes read from the client
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+static bool hasRequest(const std::vector<char> &in)
+{
+    return in.size() >= 4 && in.size() - 4 >= getU32(in.data());
+}
+
+// ##########################################################
+// @par Name
+// WordCountServer
+// @purpose
+// creates a server that will listen on a socket path
+// @param [in] :
+// const string &path - file system path of the socket
+// Backend b - backend used when a reload has to count a text
+//			file
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// nothing is opened until start is called
+//###########################################################
+WordCountServer::WordCountServer(const string &path, Backend b)
+    : socketPath(path), backend(b), positions(false), positionMode(POSITION_OFFSETS), listenFd(-1), epollFd(-1), wakeFd(-1), stopping(false),
+      snapshot(std::make_shared<CountSnapshot>()), reloads(0), reloadClient(-1), reloadDone(false) {}
+
+// ##########################################################
+// @par Name
+// buildSnapshot
+// @purpose
+// builds the counts to serve from a file
+// @param [in] :
+// const string &filename - a count file, or text to be counted
+// Backend b - backend used to count text
+// bool positions - also index where each word of a text appears
+// PositionMode mode - what the postings record
+// @return
+// std::shared_ptr<const CountSnapshot> - null on failure
+// @par References
+// None
+// @par Notes
+// count files are loaded as they are; anything else is read
+// by a WordCount first
+//###########################################################
+std::shared_ptr<const CountSnapshot> WordCountServer::buildSnapshot(const string &filename, Backend b, bool positions,
+																PositionMode mode)
+{
+    std::shared_ptr<CountSnapshot> snap = std::make_shared<CountSnapshot>();
+    if (CountFileReader(filename).isOpen())
+	   return snap->load(filename) ? snap : nullptr;
+
+    if (!std::ifstream(filename).good())
+	   return nullptr;
+    WordCount counter(filename, b);
+    if (positions)
+	   counter.indexPositions(mode);
+    if (!counter.read())
+	   return nullptr;
+    return counter.fillSnapshot(*snap) ? snap : nullptr;
+}
+
+// ##########################################################
+// @par Name
+// indexPositions
+// @purpose
+// makes every text the server counts also record where each
+// word appears, for POSITIONS requests
+// @param [in] :
+// PositionMode mode - what the postings record
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// applies to the snapshots built by later reloads
+//###########################################################
+void WordCountServer::indexPositions(PositionMode mode)
+{
+    this->positions = true;
+    this->positionMode = mode;
+}
+
+// ##########################################################
+// @par Name
+// start
+// @purpose
+// creates the socket and the event loop
+// @param [in] :
+// None
+// @return
+// bool - false if the socket could not be created
+// @par References
+// None
+// @par Notes
+// a stale socket file left at the path is replaced
+//###########################################################
+bool WordCountServer::start()
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (this->socketPath.size() >= sizeof(address.sun_path))
+	   return false;
+    std::memcpy(address.sun_path, this->socketPath.c_str(), this->socketPath.size() + 1);
+
+    this->listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (this->listenFd < 0)
+	   return false;
+    unlink(this->socketPath.c_str());
+    if (bind(this->listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+	   ::listen(this->listenFd, SOMAXCONN) < 0)
+	   return false;
+
+    this->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    this->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (this->epollFd < 0 || this->wakeFd < 0)
+	   return false;
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = this->listenFd;
+    epoll_ctl(this->epollFd, EPOLL_CTL_ADD, this->listenFd, &event);
+    event.data.fd = this->wakeFd;
+    epoll_ctl(this->epollFd, EPOLL_CTL_ADD, this->wakeFd, &event);
+    return true;
+}
+
+// ##########################################################
+// @par Name
+// setSnapshot
+// @purpose
+// sets the counts answered by the server
+// @param [in] :
+// std::shared_ptr<const CountSnapshot> snap - counts to serve
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// call before run; later changes go through RELOAD
+//###########################################################
+void WordCountServer::setSnapshot(std::shared_ptr<const CountSnapshot> snap)
+{
+    if (snap)
+	   this->snapshot = std::move(snap);
+}
+
+// ##########################################################
+// @par Name
+// run
+// @purpose
+// serves clients until stop is called
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// a single thread owns every client and the snapshot, so no
+// query ever sees a half finished reload
+//###########################################################
+void WordCountServer::run()
+{
+    epoll_event events[SERVER_MAX_EVENTS];
+    while (!this->stopping)
+    {
+	   int ready = epoll_wait(this->epollFd, events, SERVER_MAX_EVENTS, -1);
+	   if (ready < 0 && errno != EINTR)
+		  break;
+
+	   for (int i = 0; i < ready; i++)
+	   {
+		  int fd = events[i].data.fd;
+		  if (fd == this->listenFd)
+			 acceptClients();
+		  else if (fd == this->wakeFd)
+		  {
+			 uint64_t value;
+			 while (read(this->wakeFd, &value, sizeof(value)) > 0)
+				;
+			 finishReload();
+		  }
+		  else
+		  {
+			 if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+				readClient(fd);
+			 if (events[i].events & EPOLLOUT)
+				handleRequests(fd);
+		  }
+	   }
+    }
+}
+
+// ##########################################################
+// @par Name
+// stop
+// @purpose
+// asks run to return
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// only writes to an eventfd, so it is safe from a signal
+// handler or another thread
+//###########################################################
+void WordCountServer::stop()
+{
+    this->stopping = true;
+    uint64_t one = 1;
+    if (this->wakeFd >= 0 && write(this->wakeFd, &one, sizeof(one)) < 0)
+	   return;
+}
+
+// ##########################################################
+// @par Name
+// ~WordCountServer
+// @purpose
+// destructor
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// waits for a running reload and removes the socket file
+//###########################################################
+WordCountServer::~WordCountServer()
+{
+    if (this->reloader.joinable())
+	   this->reloader.join();
+    for (auto &client : this->clients)
+	   close(client.first);
+    if (this->listenFd >= 0)
+    {
+	   close(this->listenFd);
+	   unlink(this->socketPath.c_str());
+    }
+    if (this->epollFd >= 0)
+	   close(this->epollFd);
+    if (this->wakeFd >= 0)
+	   close(this->wakeFd);
+}
+
+// ##########################################################
+// @par Name
+// acceptClients
+// @purpose
+// accepts every pending connection
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void WordCountServer::acceptClients()
+{
+    while (true)
+    {
+	   int fd = accept4(this->listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+	   if (fd < 0)
+		  return;
+
+	   epoll_event event{};
+	   event.events = EPOLLIN;
+	   event.data.fd = fd;
+	   if (epoll_ctl(this->epollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+	   {
+		  close(fd);
+		  continue;
+	   }
+	   this->clients[fd] = Client{std::vector<char>(), std::vector<char>(), 0, false, false, false, false};
+    }
+}
+
+// ##########################################################
+// @par Name
+// readClient
+// @purpose
+// reads what a client sent and answers its complete requests
+// @param [in] :
+// int fd - socket of the client
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// a client that shuts down its side still gets answers to the
+// requests it sent first and is dropped once they are written;
+// an error drops it right away. An fd that is no longer a client,
+// closed by an earlier event of the same wake up, is skipped
+//###########################################################
+void WordCountServer::readClient(int fd)
+{
+    auto found = this->clients.find(fd);
+    if (found == this->clients.end())
+	   return;
+    Client &client = found->second;
+    if (client.closing)
+    {
+	   closeClient(fd);
+	   return;
+    }
+
+    char buffer[1 << 16];
+    while (true)
+    {
+	   ssize_t got = read(fd, buffer, sizeof(buffer));
+	   if (got > 0)
+		  client.in.insert(client.in.end(), buffer, buffer + got);
+	   else if (got < 0 && errno == EINTR)
+		  continue;
+	   else if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		  break;
+	   else if (got == 0)
+	   {
+		  client.closing = true;
+		  break;
+	   }
+	   else
+	   {
+		  closeClient(fd);
+		  return;
+	   }
+    }
+    handleRequests(fd);
+}
+
+// ##########################################################
+// @par Name
+// writeClient
+// @purpose
+// sends as much of a client's pending responses as the socket
+// takes
+// @param [in] :
+// int fd - socket of the client
+// @return
+// bool - false if the client was dropped
+// @par References
+// None
+// @par Notes
+// the loop only waits for the socket to become writable while
+// responses are left over, and stops reading from a client
+// that hung up or has SERVER_MAX_PENDING bytes of responses
+// left over. Sent bytes are dropped once there are as many, so
+// a client that never catches up does not grow its buffer. A
+// client that hung up is dropped once it has no response or
+// whole request left
+//###########################################################
+bool WordCountServer::writeClient(int fd)
+{
+    auto found = this->clients.find(fd);
+    if (found == this->clients.end())
+	   return false;
+    Client &client = found->second;
+    while (client.sent < client.out.size())
+    {
+	   ssize_t put = send(fd, client.out.data() + client.sent, client.out.size() - client.sent, MSG_NOSIGNAL);
+	   if (put > 0)
+		  client.sent += put;
+	   else if (put < 0 && errno == EINTR)
+		  continue;
+	   else if (put < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		  break;
+	   else
+	   {
+		  closeClient(fd);
+		  return false;
+	   }
+    }
+    if (client.sent == client.out.size())
+    {
+	   client.out.clear();
+	   client.sent = 0;
+    }
+    else if (client.sent >= SERVER_MAX_PENDING)
+    {
+	   client.out.erase(client.out.begin(), client.out.begin() + client.sent);
+	   client.sent = 0;
+    }
+
+    bool writing = !client.out.empty();
+    bool full = client.out.size() - client.sent >= SERVER_MAX_PENDING;
+    if (client.closing && !writing && !client.waiting && !hasRequest(client.in))
+    {
+	   closeClient(fd);
+	   return false;
+    }
+    if (writing != client.writing || full != client.full || client.closing)
+    {
+	   epoll_event event{};
+	   event.events = 0;
+	   if (!client.closing && !full)
+		  event.events |= EPOLLIN;
+	   if (writing)
+		  event.events |= EPOLLOUT;
+	   event.data.fd = fd;
+	   epoll_ctl(this->epollFd, EPOLL_CTL_MOD, fd, &event);
+	   client.writing = writing;
+	   client.full = full;
+    }
+    return true;
+}
+
+// ##########################################################
+// @par Name
+// closeClient
+// @purpose
+// disconnects a client
+// @param [in] :
+// int fd - socket of the client
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// a reload the client asked for still finishes and is served
+// to everyone else
+//###########################################################
+void WordCountServer::closeClient(int fd)
+{
+    epoll_ctl(this->epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    this->clients.erase(fd);
+    if (this->reloadClient == fd)
+	   this->reloadClient = -1;
+}
+
+// ##########################################################
+// @par Name
+// handleRequests
+// @purpose
+// answers every complete request a client has sent
+// @param [in] :
+// int fd - socket of the client
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// stops at a reload so later requests see the new counts and
+// responses stay in order. Also stops while SERVER_MAX_PENDING
+// bytes of responses are unsent, carrying on as the socket
+// takes them; the rest wait for the client to become writable
+//###########################################################
+void WordCountServer::handleRequests(int fd)
+{
+    auto found = this->clients.find(fd);
+    if (found == this->clients.end())
+	   return;
+    Client &client = found->second;
+    bool more = true;
+    while (more)
+    {
+	   size_t used = 0;
+	   while (!client.waiting && client.out.size() - client.sent < SERVER_MAX_PENDING && client.in.size() - used >= 4)
+	   {
+		  uint32_t length = getU32(client.in.data() + used);
+		  if (length == 0 || length > SERVER_MAX_REQUEST)
+		  {
+			 closeClient(fd);
+			 return;
+		  }
+		  if (client.in.size() - used - 4 < length)
+			 break;
+
+		  const char *body = client.in.data() + used + 4;
+		  used += 4 + length;
+		  if (!handle(fd, static_cast<uint8_t>(body[0]), body + 1, length - 1, client.out))
+			 client.waiting = true;
+	   }
+	   client.in.erase(client.in.begin(), client.in.begin() + used);
+	   more = !client.waiting && client.out.size() - client.sent >= SERVER_MAX_PENDING;
+	   if (!writeClient(fd))
+		  return;
+	   more = more && client.out.size() - client.sent < SERVER_MAX_PENDING;
+    }
+}
+
+// ##########################################################
+// @par Name
+// handle
+// @purpose
+// answers one request
+// @param [in] :
+// int fd - socket of the client
+// uint8_t op - opcode of the request
+// const char *body - arguments of the request
+// size_t len - length of the arguments
+// @return
+// bool - false if the response comes later from a reload
+// @par References
+// std::vector<char> &out - gets the response frame
+// @par Notes
+// None
+//###########################################################
+bool WordCountServer::handle(int fd, uint8_t op, const char *body, size_t len, std::vector<char> &out)
+{
+    const CountSnapshot &snap = *this->snapshot;
+    size_t start = out.size();
+    putU32(out, 0);
+    out.push_back(STATUS_OK);
+
+    size_t listed = 0;
+    size_t countAt = 0;
+    auto list = [&out, &listed](std::string_view word, uint64_t count)
+    {
+	   putU32(out, static_cast<uint32_t>(word.size()));
+	   out.insert(out.end(), word.begin(), word.end());
+	   putU64(out, count);
+	   listed++;
+    };
+    auto beginList = [&out, &countAt]()
+    {
+	   countAt = out.size();
+	   putU32(out, 0);
+    };
+
+    switch (op)
+    {
+    case OP_COUNT:
+	   putU64(out, snap.count(std::string_view(body, len)));
+	   break;
+    case OP_TOP_K:
+	   if (len != 4)
+	   {
+		  out[start + 4] = STATUS_BAD_REQUEST;
+		  break;
+	   }
+	   beginList();
+	   snap.topK(std::min<size_t>(getU32(body), SERVER_MAX_RESULTS), list);
+	   break;
+    case OP_PREFIX:
+    case OP_RANGE:
+    {
+	   size_t limit = len >= 4 ? getU32(body) : 0;
+	   if (limit == 0 || limit > SERVER_MAX_RESULTS)
+		  limit = SERVER_MAX_RESULTS;
+	   if (op == OP_PREFIX && len >= 4)
+	   {
+		  beginList();
+		  snap.prefix(std::string_view(body + 4, len - 4), limit, list);
+	   }
+	   else if (op == OP_RANGE && len >= 8 && getU32(body + 4) <= len - 8)
+	   {
+		  size_t lowLen = getU32(body + 4);
+		  beginList();
+		  snap.range(std::string_view(body + 8, lowLen), std::string_view(body + 8 + lowLen, len - 8 - lowLen),
+				   limit, list);
+	   }
+	   else
+		  out[start + 4] = STATUS_BAD_REQUEST;
+	   break;
+    }
+    case OP_RELOAD:
+	   if (startReload(fd, string(body, len)))
+	   {
+		  out.resize(start);
+		  return false;
+	   }
+	   out[start + 4] = STATUS_BUSY;
+	   break;
+    case OP_STATS:
+	   putU64(out, snap.size());
+	   putU64(out, snap.totalCount());
+	   putU64(out, this->reloads);
+	   break;
+    case OP_POSITIONS:
+	   if (!snap.hasPositions())
+	   {
+		  out[start + 4] = STATUS_NO_POSITIONS;
+		  break;
+	   }
+	   beginList();
+	   for (const Posting &posting : snap.positionsOf(std::string_view(body, len)))
+	   {
+		  if (listed == SERVER_MAX_RESULTS)
+			 break;
+		  putU64(out, posting.line);
+		  putU64(out, posting.offset);
+		  listed++;
+	   }
+	   break;
+    default:
+	   out[start + 4] = STATUS_UNKNOWN_OP;
+	   break;
+    }
+
+    if (out[start + 4] != STATUS_OK)
+	   out.resize(start + 5);
+    else if (countAt > 0)
+    {
+	   std::vector<char> number;
+	   putU32(number, static_cast<uint32_t>(listed));
+	   std::copy(number.begin(), number.end(), out.begin() + countAt);
+    }
+    std::vector<char> length;
+    putU32(length, static_cast<uint32_t>(out.size() - start - 4));
+    std::copy(length.begin(), length.end(), out.begin() + start);
+    return true;
+}
+
+// ##########################################################
+// @par Name
+// startReload
+// @purpose
+// builds new counts on a worker thread
+// @param [in] :
+// int fd - socket of the client that asked
+// const string &path - count file or text to load
+// @return
+// bool - false if another reload is still running
+// @par References
+// None
+// @par Notes
+// only one reload runs at a time
+//###########################################################
+bool WordCountServer::startReload(int fd, const string &path)
+{
+    if (this->reloader.joinable())
+	   return false;
+
+    this->reloadClient = fd;
+    this->reloadDone = false;
+    Backend b = this->backend;
+    bool positions = this->positions;
+    PositionMode mode = this->positionMode;
+    this->reloader = std::thread([this, path, b, positions, mode]()
+    {
+	   std::shared_ptr<const CountSnapshot> snap = buildSnapshot(path, b, positions, mode);
+	   {
+		  std::lock_guard<std::mutex> guard(this->reloadLock);
+		  this->reloaded = std::move(snap);
+		  this->reloadDone = true;
+	   }
+	   uint64_t one = 1;
+	   if (write(this->wakeFd, &one, sizeof(one)) < 0)
+		  return;
+    });
+    return true;
+}
+
+// ##########################################################
+// @par Name
+// finishReload
+// @purpose
+// swaps in the counts built by a finished reload and answers
+// the client that asked for it
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the old snapshot is freed here unless a reload failed, in
+// which case it keeps being served
+//###########################################################
+void WordCountServer::finishReload()
+{
+    std::shared_ptr<const CountSnapshot> snap;
+    {
+	   std::lock_guard<std::mutex> guard(this->reloadLock);
+	   if (!this->reloadDone)
+		  return;
+	   snap = std::move(this->reloaded);
+	   this->reloadDone = false;
+    }
+    this->reloader.join();
+
+    bool loaded = snap != nullptr;
+    if (loaded)
+    {
+	   this->snapshot = std::move(snap);
+	   this->reloads++;
+    }
+
+    int fd = this->reloadClient;
+    this->reloadClient = -1;
+    auto found = this->clients.find(fd);
+    if (found == this->clients.end())
+	   return;
+
+    std::vector<char> &out = found->second.out;
+    if (loaded)
+    {
+	   putU32(out, 9);
+	   out.push_back(STATUS_OK);
+	   putU64(out, this->snapshot->size());
+    }
+    else
+    {
+	   putU32(out, 1);
+	   out.push_back(STATUS_RELOAD_FAILED);
+    }
+    found->second.waiting = false;
+    handleRequests(fd);
+}
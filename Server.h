@@ -0,0 +1,135 @@
+//##########################################################
+// File: Server.h
+// Description: This file contains the class definition for
+//			 WordCountServer, which answers count queries
+//			 over a Unix domain socket
+//##########################################################
+
+#ifndef SERVER_H
+#define SERVER_H
+#include "CountSnapshot.h"
+#include "WordCount.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using std::string;
+
+// Every message is a frame of a little endian uint32 body length
+// followed by the body. A request body is an opcode byte and its
+// arguments; a response body is a status byte and its results.
+// Responses come back in request order, so clients may pipeline.
+//
+//   COUNT   word                  -> uint64 count
+//   TOP_K   uint32 k              -> list
+//   PREFIX  uint32 limit, prefix  -> list
+//   RANGE   uint32 limit, uint32 length of low, low, high
+//                                 -> list of words in [low, high)
+//   RELOAD  path                  -> uint64 number of words
+//   STATS   (nothing)             -> uint64 words, uint64 total,
+//                                    uint64 reloads
+//   POSITIONS word                -> uint32 entry count, then per
+//                                    entry uint64 line, uint64 offset
+//
+// A list is a uint32 entry count, then per entry a uint32 word
+// length, the word and a uint64 count. An empty high means the
+// range has no end and a limit of 0 means SERVER_MAX_RESULTS.
+// POSITIONS needs the server to index positions; offsets are 0
+// when it only records lines, and it answers NO_POSITIONS for
+// counts loaded from a count file.
+enum ServerOp : uint8_t
+{
+    OP_COUNT = 1,
+    OP_TOP_K,
+    OP_PREFIX,
+    OP_RANGE,
+    OP_RELOAD,
+    OP_STATS,
+    OP_POSITIONS
+};
+
+enum ServerStatus : uint8_t
+{
+    STATUS_OK,
+    STATUS_BAD_REQUEST,
+    STATUS_UNKNOWN_OP,
+    STATUS_RELOAD_FAILED,
+    STATUS_BUSY,
+    STATUS_NO_POSITIONS
+};
+
+// largest request body accepted before a client is dropped
+const size_t SERVER_MAX_REQUEST = 1 << 20;
+// most entries returned in one list
+const size_t SERVER_MAX_RESULTS = 100000;
+// events handled per wake up of the event loop
+const int SERVER_MAX_EVENTS = 64;
+// bytes of responses a client may leave unread before the server
+// stops reading and answering its requests
+const size_t SERVER_MAX_PENDING = 1 << 24;
+
+class WordCountServer
+{
+private:
+    struct Client
+    {
+	   std::vector<char> in;
+	   std::vector<char> out;
+	   size_t sent;
+	   bool waiting;
+	   bool writing;
+	   bool closing;
+	   bool full;
+    };
+
+    string socketPath;
+    Backend backend;
+    bool positions;
+    PositionMode positionMode;
+    int listenFd;
+    int epollFd;
+    int wakeFd;
+    std::atomic<bool> stopping;
+    std::shared_ptr<const CountSnapshot> snapshot;
+    std::unordered_map<int, Client> clients;
+    uint64_t reloads;
+
+    std::thread reloader;
+    std::mutex reloadLock;
+    int reloadClient;
+    bool reloadDone;
+    std::shared_ptr<const CountSnapshot> reloaded;
+
+    void acceptClients();
+    void readClient(int fd);
+    bool writeClient(int fd);
+    void closeClient(int fd);
+    void handleRequests(int fd);
+    bool handle(int fd, uint8_t op, const char *body, size_t len, std::vector<char> &out);
+    bool startReload(int fd, const string &path);
+    void finishReload();
+
+public:
+    WordCountServer(const string &path, Backend b = AVL_TREE);
+    WordCountServer(const WordCountServer &other) = delete;
+    WordCountServer &operator=(const WordCountServer &other) = delete;
+
+    static std::shared_ptr<const CountSnapshot> buildSnapshot(const string &filename, Backend b, bool positions = false,
+														 PositionMode mode = POSITION_OFFSETS);
+
+    void indexPositions(PositionMode mode);
+    bool start();
+    void setSnapshot(std::shared_ptr<const CountSnapshot> snap);
+    void run();
+    void stop();
+
+    ~WordCountServer();
+};
+
+#endif
@@ -0,0 +1,340 @@
+//##########################################################
+// File: SpaceSaving.cpp
+// Description: This file contains the class implementation
+//			 for SpaceSaving
+//##########################################################
+
+#include "SpaceSaving.h"
+#include <algorithm>
+#include <utility>
+
+// ##########################################################
+// @par Name
+// SpaceSaving
+// @purpose
+// creates a tracker that monitors k words
+// @param [in] :
+// size_t k - number of monitored words
+// @return
+// None
+// @par References
+// Metwally et al., Efficient computation of frequent and top-k
+// elements in data streams
+// @par Notes
+// monitored words sit in a min-heap by count and are found
+// through an open addressing table of heap indices
+//###########################################################
+SpaceSaving::SpaceSaving(size_t k) : capacity(k < 1 ? 1 : k), total(0)
+{
+    size_t tableSize = 4;
+    while (tableSize < this->capacity * 2)
+	   tableSize <<= 1;
+    this->slots.assign(tableSize, -1);
+    this->heap.reserve(this->capacity);
+}
+
+// ##########################################################
+// @par Name
+// add
+// @purpose
+// records count occurrences of a word
+// @param [in] :
+// const string &word - word to record
+// uint64_t hash - 64 bit hash of the word
+// uint64_t count - number of occurrences to add
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// an unmonitored word replaces the word with the smallest
+// count and inherits that count as its error
+//###########################################################
+void SpaceSaving::add(const string &word, uint64_t hash, uint64_t count)
+{
+    this->total += count;
+
+    size_t slot = findSlot(word, hash);
+    if (this->slots[slot] >= 0)
+    {
+	   size_t index = static_cast<size_t>(this->slots[slot]);
+	   this->heap[index].wordCount += count;
+	   siftDown(index);
+	   return;
+    }
+
+    if (this->heap.size() < this->capacity)
+    {
+	   this->heap.push_back({word, hash, count, 0, 0});
+	   insertSlot(this->heap.size() - 1);
+	   siftUp(this->heap.size() - 1);
+	   return;
+    }
+
+    SpaceSavingEntry &smallest = this->heap[0];
+    eraseSlot(smallest.slot);
+    smallest.element = word;
+    smallest.hash = hash;
+    smallest.error = smallest.wordCount;
+    smallest.wordCount += count;
+    insertSlot(0);
+    siftDown(0);
+}
+
+// ##########################################################
+// @par Name
+// top
+// @purpose
+// gets the monitored words from most to least frequent
+// @param [in] :
+// None
+// @return
+// vector<SpaceSavingEntry>
+// @par References
+// None
+// @par Notes
+// each word's true count lies in [wordCount - error, wordCount]
+//###########################################################
+vector<SpaceSavingEntry> SpaceSaving::top() const
+{
+    vector<SpaceSavingEntry> result(this->heap);
+    std::sort(result.begin(), result.end(), [](const SpaceSavingEntry &a, const SpaceSavingEntry &b)
+    {
+	   return a.wordCount != b.wordCount ? a.wordCount > b.wordCount : a.element < b.element;
+    });
+    return result;
+}
+
+// ##########################################################
+// @par Name
+// errorBound
+// @purpose
+// gets the most any monitored count can exceed its true count
+// @param [in] :
+// None
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// any word occurring more than this many times is monitored
+//###########################################################
+uint64_t SpaceSaving::errorBound() const
+{
+    return this->total / this->capacity;
+}
+
+// ##########################################################
+// @par Name
+// memoryUsage
+// @purpose
+// estimates the bytes held by the tracker
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t SpaceSaving::memoryUsage() const
+{
+    size_t bytes = this->heap.capacity() * sizeof(SpaceSavingEntry) + this->slots.size() * sizeof(int32_t);
+    for (const SpaceSavingEntry &e : this->heap)
+	   if (e.element.capacity() > string().capacity())
+		  bytes += e.element.capacity() + 1;
+    return bytes;
+}
+
+// ##########################################################
+// @par Name
+// clear
+// @purpose
+// forgets every word added
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void SpaceSaving::clear()
+{
+    this->heap.clear();
+    std::fill(this->slots.begin(), this->slots.end(), -1);
+    this->total = 0;
+}
+
+// ##########################################################
+// @par Name
+// findSlot
+// @purpose
+// finds the table slot of a word, or the empty slot where it
+// would go
+// @param [in] :
+// const string &word - word to be searched for
+// uint64_t hash - 64 bit hash of the word
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t SpaceSaving::findSlot(const string &word, uint64_t hash) const
+{
+    size_t mask = this->slots.size() - 1;
+    size_t slot = hash & mask;
+    while (this->slots[slot] >= 0)
+    {
+	   const SpaceSavingEntry &e = this->heap[this->slots[slot]];
+	   if (e.hash == hash && e.element == word)
+		  break;
+	   slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+// ##########################################################
+// @par Name
+// insertSlot
+// @purpose
+// records the heap index of an entry in the table
+// @param [in] :
+// size_t index - heap index of the entry
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void SpaceSaving::insertSlot(size_t index)
+{
+    SpaceSavingEntry &e = this->heap[index];
+    size_t slot = findSlot(e.element, e.hash);
+    this->slots[slot] = static_cast<int32_t>(index);
+    e.slot = slot;
+}
+
+// ##########################################################
+// @par Name
+// eraseSlot
+// @purpose
+// removes a table slot, shifting later entries of its probe
+// run back so lookups never stop early
+// @param [in] :
+// size_t slot - slot to empty
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void SpaceSaving::eraseSlot(size_t slot)
+{
+    size_t mask = this->slots.size() - 1;
+    this->slots[slot] = -1;
+    size_t next = (slot + 1) & mask;
+    while (this->slots[next] >= 0)
+    {
+	   SpaceSavingEntry &e = this->heap[this->slots[next]];
+	   size_t home = e.hash & mask;
+	   bool between = slot <= next ? (slot < home && home <= next) : (slot < home || home <= next);
+	   if (!between)
+	   {
+		  this->slots[slot] = this->slots[next];
+		  this->slots[next] = -1;
+		  e.slot = slot;
+		  slot = next;
+	   }
+	   next = (next + 1) & mask;
+    }
+}
+
+// ##########################################################
+// @par Name
+// swapEntries
+// @purpose
+// swaps two heap entries and fixes their table slots
+// @param [in] :
+// size_t a - heap index of the first entry
+// size_t b - heap index of the second entry
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void SpaceSaving::swapEntries(size_t a, size_t b)
+{
+    std::swap(this->heap[a], this->heap[b]);
+    this->slots[this->heap[a].slot] = static_cast<int32_t>(a);
+    this->slots[this->heap[b].slot] = static_cast<int32_t>(b);
+}
+
+// ##########################################################
+// @par Name
+// siftUp
+// @purpose
+// moves an entry toward the root while it is smaller than
+// its parent
+// @param [in] :
+// size_t index - heap index of the entry
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void SpaceSaving::siftUp(size_t index)
+{
+    while (index > 0)
+    {
+	   size_t parent = (index - 1) / 2;
+	   if (this->heap[parent].wordCount <= this->heap[index].wordCount)
+		  break;
+	   swapEntries(parent, index);
+	   index = parent;
+    }
+}
+
+// ##########################################################
+// @par Name
+// siftDown
+// @purpose
+// moves an entry toward the leaves while it is larger than
+// one of its children
+// @param [in] :
+// size_t index - heap index of the entry
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void SpaceSaving::siftDown(size_t index)
+{
+    size_t n = this->heap.size();
+    while (true)
+    {
+	   size_t smallest = index;
+	   size_t left = index * 2 + 1;
+	   size_t right = left + 1;
+	   if (left < n && this->heap[left].wordCount < this->heap[smallest].wordCount)
+		  smallest = left;
+	   if (right < n && this->heap[right].wordCount < this->heap[smallest].wordCount)
+		  smallest = right;
+	   if (smallest == index)
+		  break;
+	   swapEntries(smallest, index);
+	   index = smallest;
+    }
+}
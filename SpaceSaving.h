@@ -0,0 +1,52 @@
+//##########################################################
+// File: SpaceSaving.h
+// Description: This file contains the class definition for
+//			 SpaceSaving, a fixed size tracker of the most
+//			 frequent words
+//##########################################################
+
+#ifndef SPACE_SAVING_H
+#define SPACE_SAVING_H
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+struct SpaceSavingEntry
+{
+    string element;
+    uint64_t hash;
+    uint64_t wordCount;
+    uint64_t error;
+    size_t slot;
+};
+
+class SpaceSaving
+{
+private:
+    size_t capacity;
+    uint64_t total;
+    vector<SpaceSavingEntry> heap;
+    vector<int32_t> slots;
+
+    size_t findSlot(const string &word, uint64_t hash) const;
+    void insertSlot(size_t index);
+    void eraseSlot(size_t slot);
+    void swapEntries(size_t a, size_t b);
+    void siftUp(size_t index);
+    void siftDown(size_t index);
+
+public:
+    explicit SpaceSaving(size_t k = 100);
+
+    void add(const string &word, uint64_t hash, uint64_t count = 1);
+    vector<SpaceSavingEntry> top() const;
+    uint64_t errorBound() const;
+    size_t memoryUsage() const;
+    void clear();
+};
+
+#endif
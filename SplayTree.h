@@ -0,0 +1,803 @@
+//##########################################################
+// File: SplayTree.h
+// Author: Nicholas Campos
+// Description: This file contains the SplayNode structure and
+//			 SplayTree template class, a counting binary
+//			 search tree that moves each word it touches to
+//			 the root
+// Date: April 9th, 2022
+//##########################################################
+
+#ifndef SPLAY_TREE_H
+#define SPLAY_TREE_H
+#include "AVLTree.h"
+#include "NodePool.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+using std::cout;
+using std::endl;
+
+template<class T>
+struct SplayNode
+{
+    SplayNode<T> *left{};
+    SplayNode<T> *right{};
+    T element;
+    uint64_t prefix;
+    uint64_t wordCount;
+};
+
+template<class T>
+class SplayTree
+{
+private:
+    SplayNode<T> *root{};
+    size_t numNodes{};
+    NodePool<SplayNode<T>> pool;
+
+    void splay(const T &data, uint64_t prefix);
+    int compare(const T &data, uint64_t prefix, const SplayNode<T> *r) const;
+    const SplayNode<T> *find(const T &data) const;
+    SplayNode<T> *clone(const SplayNode<T> *r);
+    SplayNode<T> *rebuild(SplayNode<T> *const *nodes, size_t count);
+
+public:
+    SplayTree();
+    SplayTree(const SplayTree<T> &tree);
+    SplayTree(SplayTree<T> &&tree) noexcept;
+
+    bool isEmpty() const;
+    size_t size() const;
+    bool contains(const T &data) const;
+    uint64_t count(const T &data) const;
+
+    void insert(const T &data, uint64_t count = 1);
+    void printTree() const;
+    void makeEmpty();
+    size_t memoryUsage() const;
+    size_t depth(const T &data) const;
+
+    template<class Visitor>
+    void forEach(Visitor visitor) const;
+    template<class Predicate>
+    size_t removeIf(Predicate shouldRemove);
+    size_t removeAll(std::vector<T> keys);
+
+    SplayTree<T> &operator=(const SplayTree<T> &tree);
+    SplayTree<T> &operator=(SplayTree<T> &&tree) noexcept;
+    void swap(SplayTree<T> &tree) noexcept;
+
+    ~SplayTree();
+};
+
+// ##########################################################
+// @par Name
+// SplayTree
+// @purpose
+// creates an empty tree
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+SplayTree<T>::SplayTree() : root(nullptr), numNodes(0) {}
+
+// ##########################################################
+// @par Name
+// SplayTree
+// @purpose
+// creates a deep copy of an existing tree
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// const SplayTree &tree - tree to be copied
+// @par Notes
+// None
+//###########################################################
+template<class T>
+SplayTree<T>::SplayTree(const SplayTree<T> &tree) : root(nullptr), numNodes(0)
+{
+    *this = tree;
+}
+
+// ##########################################################
+// @par Name
+// SplayTree
+// @purpose
+// takes over the nodes of an existing tree without copying
+// them
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// SplayTree &&tree - tree left empty
+// @par Notes
+// None
+//###########################################################
+template<class T>
+SplayTree<T>::SplayTree(SplayTree<T> &&tree) noexcept : root(nullptr), numNodes(0)
+{
+    swap(tree);
+}
+
+// ##########################################################
+// @par Name
+// isEmpty
+// @purpose
+// determines if the tree is empty or not
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+bool SplayTree<T>::isEmpty() const
+{
+    return this->root == nullptr;
+}
+
+// ##########################################################
+// @par Name
+// size
+// @purpose
+// gets the number of distinct elements in the tree
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+size_t SplayTree<T>::size() const
+{
+    return this->numNodes;
+}
+
+// ##########################################################
+// @par Name
+// contains
+// @purpose
+// determines if data is in the tree
+// @param [in] :
+// const T &data - data to be searched for
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// queries do not splay, so the tree can be read from several
+// threads once counting is done
+//###########################################################
+template<class T>
+bool SplayTree<T>::contains(const T &data) const
+{
+    return find(data) != nullptr;
+}
+
+// ##########################################################
+// @par Name
+// count
+// @purpose
+// gets the number of times data was inserted
+// @param [in] :
+// const T &data - data to be searched for
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+uint64_t SplayTree<T>::count(const T &data) const
+{
+    const SplayNode<T> *node = find(data);
+    return node == nullptr ? 0 : node->wordCount;
+}
+
+// ##########################################################
+// @par Name
+// insert
+// @purpose
+// adds occurrences of data to the tree and moves it to the
+// root
+// @param [in] :
+// const T &data - data to be entered into the tree
+// uint64_t count - number of occurrences to add
+// @return
+// None
+// @par References
+// Sleator and Tarjan, Self-Adjusting Binary Search Trees
+// @par Notes
+// the same counting semantics as AVLTree::insert. A frequent
+// word is found near the root because it was touched recently,
+// so Zipfian text walks few nodes per word without any
+// rebalancing by key. A word already at the root costs one
+// compare
+//###########################################################
+template<class T>
+void SplayTree<T>::insert(const T &data, uint64_t count)
+{
+    uint64_t prefix = keyPrefix(data);
+    if (this->root != nullptr)
+    {
+	   splay(data, prefix);
+	   int order = compare(data, prefix, this->root);
+	   if (order == 0)
+	   {
+		  this->root->wordCount += count;
+		  return;
+	   }
+
+	   SplayNode<T> *node = this->pool.create();
+	   node->element = data;
+	   node->prefix = prefix;
+	   node->wordCount = count;
+	   if (order < 0)
+	   {
+		  node->left = this->root->left;
+		  node->right = this->root;
+		  this->root->left = nullptr;
+	   }
+	   else
+	   {
+		  node->right = this->root->right;
+		  node->left = this->root;
+		  this->root->right = nullptr;
+	   }
+	   this->root = node;
+    }
+    else
+    {
+	   this->root = this->pool.create();
+	   this->root->element = data;
+	   this->root->prefix = prefix;
+	   this->root->wordCount = count;
+    }
+    this->numNodes++;
+}
+
+// ##########################################################
+// @par Name
+// splay
+// @purpose
+// moves data, or the last node on its search path, to the root
+// @param [in] :
+// const T &data - data to be searched for
+// uint64_t prefix - keyPrefix of data
+// @return
+// None
+// @par References
+// Sleator and Tarjan, Self-Adjusting Binary Search Trees
+// @par Notes
+// top-down splaying in one pass with no recursion or parent
+// pointers; nodes passed on the way are hung from the left and
+// right trees and reattached at the end
+//###########################################################
+template<class T>
+void SplayTree<T>::splay(const T &data, uint64_t prefix)
+{
+    SplayNode<T> header;
+    SplayNode<T> *leftMax = &header;
+    SplayNode<T> *rightMin = &header;
+    SplayNode<T> *r = this->root;
+    while (true)
+    {
+	   int order = compare(data, prefix, r);
+	   if (order < 0)
+	   {
+		  if (r->left == nullptr)
+			 break;
+		  if (compare(data, prefix, r->left) < 0)
+		  {
+			 SplayNode<T> *child = r->left;
+			 r->left = child->right;
+			 child->right = r;
+			 r = child;
+			 if (r->left == nullptr)
+				break;
+		  }
+		  rightMin->left = r;
+		  rightMin = r;
+		  r = r->left;
+	   }
+	   else if (order > 0)
+	   {
+		  if (r->right == nullptr)
+			 break;
+		  if (compare(data, prefix, r->right) > 0)
+		  {
+			 SplayNode<T> *child = r->right;
+			 r->right = child->left;
+			 child->left = r;
+			 r = child;
+			 if (r->right == nullptr)
+				break;
+		  }
+		  leftMax->right = r;
+		  leftMax = r;
+		  r = r->right;
+	   }
+	   else
+		  break;
+    }
+    leftMax->right = r->left;
+    rightMin->left = r->right;
+    r->left = header.right;
+    r->right = header.left;
+    this->root = r;
+}
+
+// ##########################################################
+// @par Name
+// compare
+// @purpose
+// compares data with the element of a node once
+// @param [in] :
+// const T &data - data being searched for
+// uint64_t prefix - keyPrefix of data
+// const SplayNode<T> *r - node to compare against
+// @return
+// int - negative if data goes left, 0 if it matches, positive
+//	   if it goes right
+// @par References
+// None
+// @par Notes
+// the packed prefixes settle most comparisons, as in AVLTree
+//###########################################################
+template<class T>
+int SplayTree<T>::compare(const T &data, uint64_t prefix, const SplayNode<T> *r) const
+{
+    if (prefix != r->prefix)
+	   return prefix < r->prefix ? -1 : 1;
+    return compareKeys(data, r->element);
+}
+
+// ##########################################################
+// @par Name
+// find
+// @purpose
+// finds the node holding data without splaying
+// @param [in] :
+// const T &data - data to be searched for
+// @return
+// const SplayNode<T> * - null if data is not in the tree
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+const SplayNode<T> *SplayTree<T>::find(const T &data) const
+{
+    uint64_t prefix = keyPrefix(data);
+    const SplayNode<T> *r = this->root;
+    while (r != nullptr)
+    {
+	   int order = compare(data, prefix, r);
+	   if (order == 0)
+		  return r;
+	   r = order < 0 ? r->left : r->right;
+    }
+    return nullptr;
+}
+
+// ##########################################################
+// @par Name
+// depth
+// @purpose
+// gets how many nodes a search for data walks
+// @param [in] :
+// const T &data - data to be searched for
+// @return
+// size_t - nodes compared, including the last one
+// @par References
+// None
+// @par Notes
+// used to check that frequent words stay near the root
+//###########################################################
+template<class T>
+size_t SplayTree<T>::depth(const T &data) const
+{
+    uint64_t prefix = keyPrefix(data);
+    size_t walked = 0;
+    for (const SplayNode<T> *r = this->root; r != nullptr; walked++)
+    {
+	   int order = compare(data, prefix, r);
+	   if (order == 0)
+		  return walked + 1;
+	   r = order < 0 ? r->left : r->right;
+    }
+    return walked;
+}
+
+// ##########################################################
+// @par Name
+// printTree
+// @purpose
+// displays the data from the tree to the console
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// pre-order like AVLTree::printTree, but with an explicit
+// stack since a splay tree can be as deep as it is large
+//###########################################################
+template<class T>
+void SplayTree<T>::printTree() const
+{
+    std::vector<const SplayNode<T> *> stack;
+    if (this->root != nullptr)
+	   stack.push_back(this->root);
+    while (!stack.empty())
+    {
+	   const SplayNode<T> *r = stack.back();
+	   stack.pop_back();
+	   cout << r->element << " - " << r->wordCount << endl;
+	   if (r->right != nullptr)
+		  stack.push_back(r->right);
+	   if (r->left != nullptr)
+		  stack.push_back(r->left);
+    }
+}
+
+// ##########################################################
+// @par Name
+// makeEmpty
+// @purpose
+// deletes every node of the tree
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// elements without destructors are dropped with their chunks
+// instead of node by node
+//###########################################################
+template<class T>
+void SplayTree<T>::makeEmpty()
+{
+    if (!std::is_trivially_destructible<T>::value)
+    {
+	   std::vector<SplayNode<T> *> stack;
+	   if (this->root != nullptr)
+		  stack.push_back(this->root);
+	   while (!stack.empty())
+	   {
+		  SplayNode<T> *r = stack.back();
+		  stack.pop_back();
+		  if (r->left != nullptr)
+			 stack.push_back(r->left);
+		  if (r->right != nullptr)
+			 stack.push_back(r->right);
+		  this->pool.destroy(r);
+	   }
+    }
+    this->root = nullptr;
+    this->numNodes = 0;
+    this->pool.release();
+}
+
+// ##########################################################
+// @par Name
+// memoryUsage
+// @purpose
+// estimates the bytes held by the tree
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+size_t SplayTree<T>::memoryUsage() const
+{
+    size_t bytes = this->numNodes * sizeof(SplayNode<T>);
+    forEach([&bytes](const T &element, uint64_t) { bytes += heapBytes(element); });
+    return bytes;
+}
+
+// ##########################################################
+// @par Name
+// forEach
+// @purpose
+// visits every element and its count in sorted order
+// @param [in] :
+// Visitor visitor - callable taking (const T &, uint64_t)
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// iterative, so a deep tree cannot overflow the call stack
+//###########################################################
+template<class T>
+template<class Visitor>
+void SplayTree<T>::forEach(Visitor visitor) const
+{
+    std::vector<const SplayNode<T> *> stack;
+    const SplayNode<T> *r = this->root;
+    while (r != nullptr || !stack.empty())
+    {
+	   while (r != nullptr)
+	   {
+		  stack.push_back(r);
+		  r = r->left;
+	   }
+	   r = stack.back();
+	   stack.pop_back();
+	   visitor(r->element, r->wordCount);
+	   r = r->right;
+    }
+}
+
+// ##########################################################
+// @par Name
+// removeIf
+// @purpose
+// removes every element the predicate selects and rebuilds
+// the rest into a balanced tree
+// @param [in] :
+// Predicate shouldRemove - callable taking (const T &, uint64_t)
+//					  and returning true for elements to remove
+// @return
+// size_t - number of elements removed
+// @par References
+// None
+// @par Notes
+// the predicate sees the elements in sorted order. Splaying
+// has no order to keep, so the rebuilt tree starts out as
+// balanced as an AVL tree
+//###########################################################
+template<class T>
+template<class Predicate>
+size_t SplayTree<T>::removeIf(Predicate shouldRemove)
+{
+    std::vector<SplayNode<T> *> kept;
+    kept.reserve(this->numNodes);
+    std::vector<SplayNode<T> *> stack;
+    SplayNode<T> *r = this->root;
+    size_t removed = 0;
+    while (r != nullptr || !stack.empty())
+    {
+	   while (r != nullptr)
+	   {
+		  stack.push_back(r);
+		  r = r->left;
+	   }
+	   r = stack.back();
+	   stack.pop_back();
+	   SplayNode<T> *right = r->right;
+	   if (shouldRemove(static_cast<const T &>(r->element), r->wordCount))
+	   {
+		  this->pool.destroy(r);
+		  removed++;
+	   }
+	   else
+		  kept.push_back(r);
+	   r = right;
+    }
+
+    if (removed > 0)
+    {
+	   this->numNodes -= removed;
+	   this->root = rebuild(kept.data(), kept.size());
+    }
+    return removed;
+}
+
+// ##########################################################
+// @par Name
+// removeAll
+// @purpose
+// removes every listed key from the tree in one pass
+// @param [in] :
+// std::vector<T> keys - keys to be removed, in any order
+// @return
+// size_t - number of keys that were in the tree
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+size_t SplayTree<T>::removeAll(std::vector<T> keys)
+{
+    std::sort(keys.begin(), keys.end());
+    size_t next = 0;
+    return removeIf([&keys, &next](const T &element, uint64_t)
+    {
+	   while (next < keys.size() && compareKeys(keys[next], element) < 0)
+		  next++;
+	   return next < keys.size() && compareKeys(keys[next], element) == 0;
+    });
+}
+
+// ##########################################################
+// @par Name
+// rebuild
+// @purpose
+// links sorted nodes into a balanced tree
+// @param [in] :
+// SplayNode<T> *const *nodes - nodes in sorted order
+// size_t count - number of nodes
+// @return
+// SplayNode<T> * - root of the new tree
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+SplayNode<T> *SplayTree<T>::rebuild(SplayNode<T> *const *nodes, size_t count)
+{
+    if (count == 0)
+	   return nullptr;
+
+    size_t mid = count / 2;
+    SplayNode<T> *r = nodes[mid];
+    r->left = rebuild(nodes, mid);
+    r->right = rebuild(nodes + mid + 1, count - mid - 1);
+    return r;
+}
+
+// ##########################################################
+// @par Name
+// clone
+// @purpose
+// copies a subtree into this tree's pool
+// @param [in] :
+// const SplayNode<T> *r - root of the subtree to copy
+// @return
+// SplayNode<T> * - root of the copy
+// @par References
+// None
+// @par Notes
+// iterative for the same reason as forEach
+//###########################################################
+template<class T>
+SplayNode<T> *SplayTree<T>::clone(const SplayNode<T> *r)
+{
+    SplayNode<T> *result = nullptr;
+    std::vector<std::pair<const SplayNode<T> *, SplayNode<T> **>> pending;
+    if (r != nullptr)
+	   pending.push_back({r, &result});
+    while (!pending.empty())
+    {
+	   const SplayNode<T> *source = pending.back().first;
+	   SplayNode<T> **slot = pending.back().second;
+	   pending.pop_back();
+
+	   SplayNode<T> *node = this->pool.create();
+	   node->element = source->element;
+	   node->prefix = source->prefix;
+	   node->wordCount = source->wordCount;
+	   *slot = node;
+	   if (source->right != nullptr)
+		  pending.push_back({source->right, &node->right});
+	   if (source->left != nullptr)
+		  pending.push_back({source->left, &node->left});
+    }
+    return result;
+}
+
+// ##########################################################
+// @par Name
+// operator=
+// @purpose
+// replaces this tree with a deep copy of another
+// @param [in] :
+// const SplayTree &tree - tree to be copied
+// @return
+// SplayTree &
+// @par References
+// None
+// @par Notes
+// the copy has the same shape as the original
+//###########################################################
+template<class T>
+SplayTree<T> &SplayTree<T>::operator=(const SplayTree<T> &tree)
+{
+    if (this != &tree)
+    {
+	   makeEmpty();
+	   this->pool.reserve(tree.numNodes);
+	   this->root = clone(tree.root);
+	   this->numNodes = tree.numNodes;
+    }
+    return *this;
+}
+
+// ##########################################################
+// @par Name
+// operator=
+// @purpose
+// takes over the nodes of another tree
+// @param [in] :
+// SplayTree &&tree - tree to be moved from
+// @return
+// SplayTree &
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+SplayTree<T> &SplayTree<T>::operator=(SplayTree<T> &&tree) noexcept
+{
+    swap(tree);
+    return *this;
+}
+
+// ##########################################################
+// @par Name
+// swap
+// @purpose
+// exchanges the nodes of two trees
+// @param [in] :
+// SplayTree &tree - tree to swap with
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+void SplayTree<T>::swap(SplayTree<T> &tree) noexcept
+{
+    std::swap(this->root, tree.root);
+    std::swap(this->numNodes, tree.numNodes);
+    this->pool.swap(tree.pool);
+}
+
+// ##########################################################
+// @par Name
+// ~SplayTree
+// @purpose
+// deletes the memory held by the tree
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class T>
+SplayTree<T>::~SplayTree()
+{
+    makeEmpty();
+}
+
+#endif
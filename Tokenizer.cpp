@@ -0,0 +1,224 @@
+//##########################################################
+// File: Tokenizer.cpp
+// Description: This file contains the class implementation
+//			 for Tokenizer
+//##########################################################
+
+#include "Tokenizer.h"
+#include <cctype>
+
+// ##########################################################
+// @par Name
+// Tokenizer
+// @purpose
+// creates a tokenizer with no partial word
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+Tokenizer::Tokenizer() : consumed(0), line(1), wordOffset(0), wordLine(1), counting(false), totals(), column(0), inWord(false)
+{
+    this->word.reserve(64);
+}
+
+// ##########################################################
+// @par Name
+// buildClasses
+// @purpose
+// classifies every byte value
+// @param [in] :
+// None
+// @return
+// CharTable
+// @par References
+// None
+// @par Notes
+// follows the C locale's isspace and ispunct; the null byte
+// separates words so no word ever contains one
+//###########################################################
+static CharTable buildClasses()
+{
+    CharTable table;
+    for (int c = 0; c < 256; c++)
+    {
+	   if (isspace(c) || c == 0)
+		  table.classes[c] = SEPARATOR;
+	   else if (ispunct(c))
+		  table.classes[c] = PUNCTUATION;
+	   else
+		  table.classes[c] = WORD_CHAR;
+    }
+    return table;
+}
+
+// ##########################################################
+// @par Name
+// classes
+// @purpose
+// gets the table classifying every byte value
+// @param [in] :
+// None
+// @return
+// const CharClass * - 256 entries
+// @par References
+// None
+// @par Notes
+// built once so the scanning loop is a table lookup per byte
+//###########################################################
+const CharClass *Tokenizer::classes()
+{
+    static const CharTable table = buildClasses();
+    return table.classes;
+}
+
+// ##########################################################
+// @par Name
+// buildStatFlags
+// @purpose
+// gives every byte value its StatFlag bits
+// @param [in] :
+// None
+// @return
+// StatTable
+// @par References
+// None
+// @par Notes
+// UTF-8 continuation bytes are neither characters nor columns;
+// every other byte starts a character. Printable ASCII and
+// UTF-8 lead bytes take one column, control characters none
+//###########################################################
+static StatTable buildStatFlags()
+{
+    StatTable table;
+    for (int c = 0; c < 256; c++)
+    {
+	   uint8_t f = 0;
+	   if (c < 0x80)
+	   {
+		  f |= STAT_CHAR;
+		  if (isprint(c))
+			 f |= STAT_COLUMN;
+		  if (isspace(c))
+			 f |= STAT_SPACE;
+		  if (c == '\n')
+			 f |= STAT_LINE_END;
+		  else if (c == '\t')
+			 f |= STAT_TAB;
+		  else if (c == '\r' || c == '\f')
+			 f |= STAT_LINE_START;
+	   }
+	   else if (c >= 0xC0)
+		  f |= STAT_CHAR | STAT_COLUMN;
+	   table.flags[c] = f;
+    }
+    return table;
+}
+
+// ##########################################################
+// @par Name
+// statFlags
+// @purpose
+// gets the table of StatFlag bits of every byte value
+// @param [in] :
+// None
+// @return
+// const uint8_t * - 256 entries
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+const uint8_t *Tokenizer::statFlags()
+{
+    static const StatTable table = buildStatFlags();
+    return table.flags;
+}
+
+// ##########################################################
+// @par Name
+// countByte
+// @purpose
+// adds one byte that is not part of a word run to the text
+// statistics
+// @param [in] :
+// uint8_t c - byte of the text
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// follows wc: words are runs of non-whitespace, tabs advance
+// to the next multiple of eight columns, and a newline,
+// carriage return or form feed ends the current line's width
+//###########################################################
+void Tokenizer::countByte(uint8_t c)
+{
+    uint8_t f = statFlags()[c];
+    this->column += f & STAT_COLUMN;
+    this->totals.chars += f >> 1 & 1;
+    if (f & STAT_SPACE)
+	   this->inWord = false;
+    else if (!this->inWord)
+    {
+	   this->inWord = true;
+	   this->totals.words++;
+    }
+
+    if (f & STAT_TAB)
+	   this->column = (this->column / 8 + 1) * 8;
+    else if (f & (STAT_LINE_END | STAT_LINE_START))
+    {
+	   if (this->column > this->totals.longestLine)
+		  this->totals.longestLine = this->column;
+	   this->column = 0;
+	   if (f & STAT_LINE_END)
+		  this->totals.lines++;
+    }
+}
+
+// ##########################################################
+// @par Name
+// countStats
+// @purpose
+// turns the text statistics on or off for later blocks
+// @param [in] :
+// bool on - true to gather the statistics
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// turn them on before the first block so the totals cover the
+// whole text
+//###########################################################
+void Tokenizer::countStats(bool on)
+{
+    this->counting = on;
+}
+
+// ##########################################################
+// @par Name
+// stats
+// @purpose
+// gets the text statistics gathered so far
+// @param [in] :
+// None
+// @return
+// TextStats
+// @par References
+// None
+// @par Notes
+// the longest line only includes an unfinished last line
+// after finish
+//###########################################################
+TextStats Tokenizer::stats() const
+{
+    TextStats result = this->totals;
+    result.bytes = this->consumed;
+    return result;
+}
@@ -0,0 +1,258 @@
+//##########################################################
+// File: Tokenizer.h
+// Description: This file contains the class definition for
+//			 Tokenizer, which splits blocks of text into
+//			 cleaned words
+//##########################################################
+
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+using std::string;
+
+// how the tokenizer treats each byte
+enum CharClass : uint8_t
+{
+    WORD_CHAR,
+    SEPARATOR,
+    PUNCTUATION
+};
+
+struct CharTable
+{
+    CharClass classes[256];
+};
+
+// what the text statistics need to know about each byte; the
+// column and character bits are the two lowest so they can be
+// added straight to their totals
+enum StatFlag : uint8_t
+{
+    STAT_COLUMN = 1,
+    STAT_CHAR = 2,
+    STAT_SPACE = 4,
+    STAT_LINE_END = 8,
+    STAT_TAB = 16,
+    STAT_LINE_START = 32
+};
+
+struct StatTable
+{
+    uint8_t flags[256];
+};
+
+// totals like those of wc, gathered while tokenizing
+struct TextStats
+{
+    uint64_t lines;
+    uint64_t bytes;
+    uint64_t chars;
+    uint64_t words;
+    uint64_t tokens;
+    uint64_t longestLine;
+};
+
+class Tokenizer
+{
+private:
+    string word;
+    uint64_t consumed;
+    uint64_t line;
+    uint64_t wordOffset;
+    uint64_t wordLine;
+
+    bool counting;
+    TextStats totals;
+    uint64_t column;
+    bool inWord;
+
+    template<class Callback>
+    void emit(Callback &callback);
+    template<bool Stats, class Callback>
+    void scan(const char *data, size_t len, Callback &callback);
+    void countByte(uint8_t c);
+
+public:
+    Tokenizer();
+
+    static const CharClass *classes();
+    static const uint8_t *statFlags();
+
+    void countStats(bool on);
+    TextStats stats() const;
+
+    template<class Callback>
+    void feed(const char *data, size_t len, Callback &&callback);
+    template<class Callback>
+    void finish(Callback &&callback);
+};
+
+// ##########################################################
+// @par Name
+// emit
+// @purpose
+// passes the finished word to the callback and clears it
+// @param [in] :
+// Callback &callback - callable taking (const string &) or
+//				   (const string &, uint64_t offset, uint64_t line)
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the offset is the byte offset of the word's first character
+// and the line is counted from 1
+//###########################################################
+template<class Callback>
+void Tokenizer::emit(Callback &callback)
+{
+    if constexpr (std::is_invocable<Callback &, const string &, uint64_t, uint64_t>::value)
+	   callback(static_cast<const string &>(this->word), this->wordOffset, this->wordLine);
+    else
+	   callback(static_cast<const string &>(this->word));
+    this->word.clear();
+    this->totals.tokens++;
+}
+
+// ##########################################################
+// @par Name
+// feed
+// @purpose
+// splits the next block of text into words and passes each
+// complete word to the callback
+// @param [in] :
+// const char *data - bytes of the block
+// size_t len - number of bytes in the block
+// Callback &&callback - callable taking (const string &), or
+//				    (const string &, uint64_t, uint64_t) to also
+//				    get the position of each word
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// words are separated by whitespace and have their punctuation
+// removed; a word cut off by the end of the block is carried
+// into the next call. Positions are kept across calls, so
+// offsets count from the start of the text
+//###########################################################
+template<class Callback>
+void Tokenizer::feed(const char *data, size_t len, Callback &&callback)
+{
+    if (this->counting)
+	   scan<true>(data, len, callback);
+    else
+	   scan<false>(data, len, callback);
+}
+
+// ##########################################################
+// @par Name
+// scan
+// @purpose
+// tokenizes a block and, when Stats is set, adds it to the
+// text statistics in the same pass
+// @param [in] :
+// const char *data - bytes of the block
+// size_t len - number of bytes in the block
+// Callback &callback - callable passed to feed
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the bytes of a word run are never whitespace, so inside a
+// run the statistics only add the column and character bits;
+// the byte ending a run goes through countByte
+//###########################################################
+template<bool Stats, class Callback>
+void Tokenizer::scan(const char *data, size_t len, Callback &callback)
+{
+    const CharClass *table = classes();
+    const uint8_t *flags = statFlags();
+    const char *end = data + len;
+    const char *p = data;
+
+    while (p < end)
+    {
+	   // copy the run of word bytes in one append
+	   const char *start = p;
+	   if constexpr (Stats)
+	   {
+		  uint64_t columns = 0;
+		  uint64_t chars = 0;
+		  for (; p < end && table[static_cast<uint8_t>(*p)] == WORD_CHAR; p++)
+		  {
+			 uint8_t f = flags[static_cast<uint8_t>(*p)];
+			 columns += f & STAT_COLUMN;
+			 chars += f >> 1 & 1;
+		  }
+		  this->column += columns;
+		  this->totals.chars += chars;
+		  if (p != start && !this->inWord)
+		  {
+			 this->inWord = true;
+			 this->totals.words++;
+		  }
+	   }
+	   else
+	   {
+		  while (p < end && table[static_cast<uint8_t>(*p)] == WORD_CHAR)
+			 p++;
+	   }
+	   if (p != start)
+	   {
+		  if (this->word.empty())
+		  {
+			 this->wordOffset = this->consumed + (start - data);
+			 this->wordLine = this->line;
+		  }
+		  this->word.append(start, p - start);
+	   }
+	   if (p == end)
+		  break;
+
+	   if constexpr (Stats)
+		  countByte(static_cast<uint8_t>(*p));
+	   if (table[static_cast<uint8_t>(*p)] == SEPARATOR)
+	   {
+		  if (!this->word.empty())
+			 emit(callback);
+		  if (*p == '\n')
+			 this->line++;
+	   }
+	   p++;
+    }
+    this->consumed += len;
+}
+
+// ##########################################################
+// @par Name
+// finish
+// @purpose
+// passes the word left at the end of the text, if any, to the
+// callback
+// @param [in] :
+// Callback &&callback - callable taking the same arguments as
+//				    for feed
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+template<class Callback>
+void Tokenizer::finish(Callback &&callback)
+{
+    if (!this->word.empty())
+	   emit(callback);
+    if (this->column > this->totals.longestLine)
+	   this->totals.longestLine = this->column;
+    this->column = 0;
+}
+
+#endif
@@ -0,0 +1,219 @@
+//##########################################################
+// File: Trace.cpp
+// Description: This file contains the class implementation
+//			 for TraceLog
+//##########################################################
+
+#include "Trace.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+
+// one finished span
+struct TraceEvent
+{
+    const char *name;
+    uint64_t start;
+    uint64_t end;
+};
+
+// spans of one thread; only that thread writes to it
+struct TraceBuffer
+{
+    std::vector<TraceEvent> events;
+    std::atomic<uint64_t> written;
+    const char *name;
+    unsigned tid;
+};
+
+std::atomic<bool> TraceLog::active{false};
+
+static std::mutex registryLock;
+static std::vector<std::unique_ptr<TraceBuffer>> registry;
+static size_t ringEvents = TRACE_RING_EVENTS;
+static uint64_t origin = 0;
+static thread_local TraceBuffer *localBuffer = nullptr;
+
+// ##########################################################
+// @par Name
+// threadBuffer
+// @purpose
+// gets the ring of the calling thread, registering one the
+// first time the thread records a span
+// @param [in] :
+// None
+// @return
+// TraceBuffer *
+// @par References
+// None
+// @par Notes
+// the registry owns the rings, so the spans of threads that
+// have already exited are still written out
+//###########################################################
+static TraceBuffer *threadBuffer()
+{
+    if (localBuffer == nullptr)
+    {
+	   std::unique_ptr<TraceBuffer> buffer(new TraceBuffer());
+	   buffer->written.store(0, std::memory_order_relaxed);
+	   buffer->name = nullptr;
+	   std::lock_guard<std::mutex> guard(registryLock);
+	   buffer->tid = static_cast<unsigned>(registry.size() + 1);
+	   localBuffer = buffer.get();
+	   registry.push_back(std::move(buffer));
+    }
+    return localBuffer;
+}
+
+// ##########################################################
+// @par Name
+// enable
+// @purpose
+// starts recording spans on every thread
+// @param [in] :
+// size_t eventsPerThread - spans kept per thread
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// meant to be called once before any traced work starts;
+// timestamps count from this call
+//###########################################################
+void TraceLog::enable(size_t eventsPerThread)
+{
+    ringEvents = eventsPerThread > 0 ? eventsPerThread : 1;
+    origin = now();
+    active.store(true, std::memory_order_release);
+}
+
+// ##########################################################
+// @par Name
+// now
+// @purpose
+// gets the time used to stamp spans
+// @param [in] :
+// None
+// @return
+// uint64_t - nanoseconds of the steady clock
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t TraceLog::now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// ##########################################################
+// @par Name
+// nameThread
+// @purpose
+// sets the name the calling thread is shown under
+// @param [in] :
+// const char *name - string literal naming the thread
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void TraceLog::nameThread(const char *name)
+{
+    if (enabled())
+	   threadBuffer()->name = name;
+}
+
+// ##########################################################
+// @par Name
+// record
+// @purpose
+// adds a finished span to the calling thread's ring
+// @param [in] :
+// const char *name - name of the span
+// uint64_t start - time the span began
+// uint64_t end - time the span ended
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the ring grows up to its capacity and then overwrites its
+// oldest span, so a long run keeps its most recent spans
+//###########################################################
+void TraceLog::record(const char *name, uint64_t start, uint64_t end)
+{
+    TraceBuffer *buffer = threadBuffer();
+    uint64_t n = buffer->written.load(std::memory_order_relaxed);
+    if (buffer->events.size() < ringEvents)
+	   buffer->events.push_back(TraceEvent{name, start, end});
+    else
+	   buffer->events[n % ringEvents] = TraceEvent{name, start, end};
+    buffer->written.store(n + 1, std::memory_order_release);
+}
+
+// ##########################################################
+// @par Name
+// write
+// @purpose
+// saves every recorded span as a Chrome trace-event file
+// @param [in] :
+// const string &filename - file to write, opened by
+//					    chrome://tracing or ui.perfetto.dev
+// @return
+// bool - false if the file could not be written
+// @par References
+// Trace Event Format, complete ("X") and metadata ("M") events
+// @par Notes
+// call once the traced work is over; threads still recording
+// would race with the copy. Span and thread names are literals
+// and are written without escaping
+//###########################################################
+bool TraceLog::write(const string &filename)
+{
+    std::ofstream out(filename);
+    if (!out)
+	   return false;
+
+    long pid = static_cast<long>(getpid());
+    bool first = true;
+    auto separate = [&out, &first]()
+    {
+	   out << (first ? "\n" : ",\n");
+	   first = false;
+    };
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    std::lock_guard<std::mutex> guard(registryLock);
+    for (const std::unique_ptr<TraceBuffer> &buffer : registry)
+    {
+	   if (buffer->name != nullptr)
+	   {
+		  separate();
+		  out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+			 << ",\"args\":{\"name\":\"" << buffer->name << "\"}}";
+	   }
+
+	   uint64_t n = buffer->written.load(std::memory_order_acquire);
+	   size_t size = buffer->events.size();
+	   uint64_t oldest = n > size ? n - size : 0;
+	   for (uint64_t i = oldest; i < n; i++)
+	   {
+		  const TraceEvent &e = buffer->events[i % size];
+		  if (e.start < origin)
+			 continue;
+		  separate();
+		  out << "{\"name\":\"" << e.name << "\",\"cat\":\"wordcount\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+			 << ",\"ts\":" << (e.start - origin) / 1000.0 << ",\"dur\":" << (e.end - e.start) / 1000.0 << "}";
+	   }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
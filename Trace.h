@@ -0,0 +1,112 @@
+//##########################################################
+// File: Trace.h
+// Description: This file contains the class definitions for
+//			 TraceLog and TraceSpan, which record timed spans
+//			 per thread for a Chrome trace-event timeline
+//##########################################################
+
+#ifndef TRACE_H
+#define TRACE_H
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+using std::string;
+
+// spans kept per thread; once a thread's ring is full its
+// oldest spans are overwritten
+const size_t TRACE_RING_EVENTS = 1 << 16;
+
+class TraceLog
+{
+private:
+    static std::atomic<bool> active;
+
+public:
+    static void enable(size_t eventsPerThread = TRACE_RING_EVENTS);
+    static bool enabled();
+    static uint64_t now();
+    static void nameThread(const char *name);
+    static void record(const char *name, uint64_t start, uint64_t end);
+    static bool write(const string &filename);
+};
+
+// records one span from its creation to the end of its scope
+// on the calling thread's ring; does nothing while tracing is
+// off
+class TraceSpan
+{
+private:
+    const char *name;
+    uint64_t start;
+    bool on;
+
+public:
+    explicit TraceSpan(const char *spanName);
+    ~TraceSpan();
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+};
+
+// ##########################################################
+// @par Name
+// enabled
+// @purpose
+// checks if spans are being recorded
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// inline so a span costs one relaxed load while tracing is off
+//###########################################################
+inline bool TraceLog::enabled()
+{
+    return active.load(std::memory_order_relaxed);
+}
+
+// ##########################################################
+// @par Name
+// TraceSpan
+// @purpose
+// starts a span
+// @param [in] :
+// const char *spanName - name shown on the timeline; must be a
+//					    string literal or otherwise outlive the trace
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+inline TraceSpan::TraceSpan(const char *spanName) : name(spanName), start(0), on(TraceLog::enabled())
+{
+    if (this->on)
+	   this->start = TraceLog::now();
+}
+
+// ##########################################################
+// @par Name
+// ~TraceSpan
+// @purpose
+// ends the span and records it
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+inline TraceSpan::~TraceSpan()
+{
+    if (this->on)
+	   TraceLog::record(this->name, this->start, TraceLog::now());
+}
+
+#endif
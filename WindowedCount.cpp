@@ -0,0 +1,493 @@
+//##########################################################
+// File: WindowedCount.cpp
+// Description: This file contains the class implementations
+//			 for WindowedCount and DecayedCount, and the loop
+//			 that feeds them a stream
+//##########################################################
+
+#include "WindowedCount.h"
+#include "Tokenizer.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+// ##########################################################
+// @par Name
+// WindowedCount
+// @purpose
+// creates a counter for the words of the last window seconds
+// @param [in] :
+// double window - length of the window in seconds
+// size_t epochs - number of epochs the window is split into
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// a word leaves the window a whole epoch at a time, so counts
+// cover between window - window / epochs and window seconds.
+// There are 1 to WINDOW_MAX_EPOCHS epochs of at least
+// WINDOW_MIN_EPOCH seconds
+//###########################################################
+WindowedCount::WindowedCount(double window, size_t epochs)
+    : epochLength(window / epochs), ring(epochs), epoch(0), total(0)
+{
+    assert(epochs >= 1 && epochs <= WINDOW_MAX_EPOCHS && this->epochLength >= WINDOW_MIN_EPOCH);
+}
+
+// ##########################################################
+// @par Name
+// add
+// @purpose
+// records one occurrence of a word
+// @param [in] :
+// const string &word - word that was read
+// double now - time of the occurrence in seconds, never less
+//			  than an earlier call
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void WindowedCount::add(const string &word, double now)
+{
+    advance(now);
+    auto entry = this->totals.emplace(word, 0).first;
+    entry->second++;
+    this->ring[this->epoch % this->ring.size()][&*entry]++;
+    this->total++;
+}
+
+// ##########################################################
+// @par Name
+// advance
+// @purpose
+// moves the window forward to a time
+// @param [in] :
+// double now - current time in seconds
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// each epoch that leaves the window has its delta subtracted
+// from the totals, so advancing costs the number of distinct
+// words in the retired epochs and never rebuilds the totals.
+// A jump longer than the window retires every epoch once
+//###########################################################
+void WindowedCount::advance(double now)
+{
+    int64_t target = static_cast<int64_t>(std::floor(now / this->epochLength));
+    if (target <= this->epoch)
+	   return;
+
+    int64_t steps = std::min<int64_t>(target - this->epoch, static_cast<int64_t>(this->ring.size()));
+    for (int64_t i = 1; i <= steps; i++)
+	   retire(this->ring[(this->epoch + i) % this->ring.size()]);
+    this->epoch = target;
+}
+
+// ##########################################################
+// @par Name
+// retire
+// @purpose
+// subtracts an epoch's counts from the totals and empties it
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// Delta &delta - epoch leaving the window
+// @par Notes
+// words whose total reaches zero are erased
+//###########################################################
+void WindowedCount::retire(Delta &delta)
+{
+    for (const auto &change : delta)
+    {
+	   this->total -= change.second;
+	   change.first->second -= change.second;
+	   if (change.first->second == 0)
+		  this->totals.erase(change.first->first);
+    }
+    delta.clear();
+}
+
+// ##########################################################
+// @par Name
+// count
+// @purpose
+// gets how many times a word appears in the window
+// @param [in] :
+// const string &word - word to be searched for
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// counts are as of the last add or advance
+//###########################################################
+uint64_t WindowedCount::count(const string &word) const
+{
+    auto found = this->totals.find(word);
+    return found == this->totals.end() ? 0 : found->second;
+}
+
+// ##########################################################
+// @par Name
+// totalCount
+// @purpose
+// gets the number of words in the window
+// @param [in] :
+// None
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+uint64_t WindowedCount::totalCount() const
+{
+    return this->total;
+}
+
+// ##########################################################
+// @par Name
+// size
+// @purpose
+// gets the number of distinct words in the window
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t WindowedCount::size() const
+{
+    return this->totals.size();
+}
+
+// ##########################################################
+// @par Name
+// top
+// @purpose
+// gets the most frequent words in the window
+// @param [in] :
+// size_t k - most words to return, 0 for all of them
+// @return
+// vector<std::pair<string, uint64_t>> - from most to least
+//					    frequent, ties alphabetically
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+vector<std::pair<string, uint64_t>> WindowedCount::top(size_t k) const
+{
+    vector<std::pair<string, uint64_t>> result(this->totals.begin(), this->totals.end());
+    auto before = [](const std::pair<string, uint64_t> &a, const std::pair<string, uint64_t> &b)
+    {
+	   return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+    if (k != 0 && k < result.size())
+    {
+	   std::partial_sort(result.begin(), result.begin() + k, result.end(), before);
+	   result.resize(k);
+    }
+    else
+	   std::sort(result.begin(), result.end(), before);
+    return result;
+}
+
+// ##########################################################
+// @par Name
+// display
+// @purpose
+// displays the most frequent words in the window
+// @param [in] :
+// size_t limit - most words to display, 0 for all of them
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void WindowedCount::display(size_t limit) const
+{
+    for (const auto &entry : top(limit))
+	   cout << entry.first << " - " << entry.second << endl;
+}
+
+// ##########################################################
+// @par Name
+// DecayedCount
+// @purpose
+// creates a counter whose scores halve every halfLife seconds
+// @param [in] :
+// double halfLife - seconds for a score to lose half its value
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// instead of shrinking every score as time passes, new words
+// are added with a weight that grows at the same rate and
+// scores are divided by the current weight when read
+//###########################################################
+DecayedCount::DecayedCount(double halfLife)
+    : rate(std::log(2.0) / (halfLife > 0 ? halfLife : 1)), origin(0), lastTime(0), weight(1) {}
+
+// ##########################################################
+// @par Name
+// add
+// @purpose
+// records one occurrence of a word
+// @param [in] :
+// const string &word - word that was read
+// double now - time of the occurrence in seconds, never less
+//			  than an earlier call
+// @return
+// None
+// @par References
+// Cormode et al., Forward Decay: A Practical Time Decay Model
+// for Streaming Systems
+// @par Notes
+// the weight is recomputed only when the time changes
+//###########################################################
+void DecayedCount::add(const string &word, double now)
+{
+    if (now != this->lastTime)
+    {
+	   if (this->rate * (now - this->origin) > DECAY_RENORMALIZE)
+		  renormalize(now);
+	   this->weight = std::exp(this->rate * (now - this->origin));
+	   this->lastTime = now;
+    }
+    this->scores[word] += this->weight;
+}
+
+// ##########################################################
+// @par Name
+// renormalize
+// @purpose
+// moves the origin of the weights to now
+// @param [in] :
+// double now - current time in seconds
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// keeps the weights from overflowing. This touches every word,
+// but only once per DECAY_RENORMALIZE / rate seconds, and
+// drops the words that have decayed below DECAY_PRUNE
+//###########################################################
+void DecayedCount::renormalize(double now)
+{
+    double scale = std::exp(-this->rate * (now - this->origin));
+    for (auto entry = this->scores.begin(); entry != this->scores.end();)
+    {
+	   entry->second *= scale;
+	   if (entry->second < DECAY_PRUNE)
+		  entry = this->scores.erase(entry);
+	   else
+		  ++entry;
+    }
+    this->origin = now;
+}
+
+// ##########################################################
+// @par Name
+// score
+// @purpose
+// gets the decayed number of occurrences of a word
+// @param [in] :
+// const string &word - word to be searched for
+// double now - time to decay the score to
+// @return
+// double
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+double DecayedCount::score(const string &word, double now) const
+{
+    auto found = this->scores.find(word);
+    if (found == this->scores.end())
+	   return 0;
+    return found->second * std::exp(-this->rate * (now - this->origin));
+}
+
+// ##########################################################
+// @par Name
+// size
+// @purpose
+// gets the number of distinct words with a score
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t DecayedCount::size() const
+{
+    return this->scores.size();
+}
+
+// ##########################################################
+// @par Name
+// top
+// @purpose
+// gets the words with the highest decayed scores
+// @param [in] :
+// size_t k - most words to return, 0 for all of them
+// double now - time to decay the scores to
+// @return
+// vector<std::pair<string, double>> - from highest to lowest
+//					  score, ties alphabetically
+// @par References
+// None
+// @par Notes
+// every score decays by the same factor, so the order is that
+// of the stored scores
+//###########################################################
+vector<std::pair<string, double>> DecayedCount::top(size_t k, double now) const
+{
+    vector<std::pair<string, double>> result(this->scores.begin(), this->scores.end());
+    auto before = [](const std::pair<string, double> &a, const std::pair<string, double> &b)
+    {
+	   return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+    if (k != 0 && k < result.size())
+    {
+	   std::partial_sort(result.begin(), result.begin() + k, result.end(), before);
+	   result.resize(k);
+    }
+    else
+	   std::sort(result.begin(), result.end(), before);
+
+    double scale = std::exp(-this->rate * (now - this->origin));
+    for (auto &entry : result)
+	   entry.second *= scale;
+    return result;
+}
+
+// ##########################################################
+// @par Name
+// display
+// @purpose
+// displays the words with the highest decayed scores
+// @param [in] :
+// size_t limit - most words to display, 0 for all of them
+// double now - time to decay the scores to
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void DecayedCount::display(size_t limit, double now) const
+{
+    for (const auto &entry : top(limit, now))
+	   cout << entry.first << " - " << entry.second << endl;
+}
+
+// ##########################################################
+// @par Name
+// streamWindowed
+// @purpose
+// counts the words of a growing stream and displays the most
+// frequent recent words as time passes
+// @param [in] :
+// const string &filename - file to read, or "-" for standard
+//				     input
+// double window - seconds of the window, used when halfLife
+//			   is 0
+// size_t epochs - number of epochs the window is split into
+// double halfLife - seconds for a decayed score to halve, 0 to
+//			     use the window instead
+// size_t limit - most words to display, 0 for all of them
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// lines are timed as they are read, so piping `tail -f` in
+// gives live counts. A report is displayed at the end of each
+// epoch, or each half life, that saw input, and at the end of
+// the stream
+//###########################################################
+void streamWindowed(const string &filename, double window, size_t epochs, double halfLife, size_t limit)
+{
+    std::ifstream file;
+    if (filename != "-")
+    {
+	   file.open(filename);
+	   if (!file)
+	   {
+		  cout << "File failed to open" << endl;
+		  return;
+	   }
+    }
+    std::istream &in = filename == "-" ? std::cin : file;
+
+    bool decay = halfLife > 0;
+    WindowedCount windowed(decay ? WINDOW_MIN_EPOCH : window, decay ? 1 : epochs);
+    DecayedCount decayed(halfLife);
+    double interval = decay ? halfLife : window / epochs;
+    auto start = std::chrono::steady_clock::now();
+    double now = 0;
+    double nextReport = interval;
+    auto report = [&]()
+    {
+	   if (!decay)
+		  windowed.advance(now);
+	   cout << "--- " << now << "s, " << (decay ? decayed.size() : windowed.size()) << " words ---" << endl;
+	   if (decay)
+		  decayed.display(limit, now);
+	   else
+		  windowed.display(limit);
+    };
+
+    Tokenizer tokenizer;
+    auto add = [&](const string &word)
+    {
+	   if (decay)
+		  decayed.add(word, now);
+	   else
+		  windowed.add(word, now);
+    };
+    string line;
+    while (std::getline(in, line))
+    {
+	   now = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	   if (now >= nextReport)
+	   {
+		  report();
+		  nextReport = (std::floor(now / interval) + 1) * interval;
+	   }
+	   line.push_back('\n');
+	   tokenizer.feed(line.data(), line.size(), add);
+    }
+    tokenizer.finish(add);
+    now = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report();
+}
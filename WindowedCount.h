@@ -0,0 +1,87 @@
+//##########################################################
+// File: WindowedCount.h
+// Description: This file contains the class definitions for
+//			 WindowedCount, which counts the words of the
+//			 last few minutes of a stream, and DecayedCount,
+//			 which weighs recent words more than old ones
+//##########################################################
+
+#ifndef WINDOWED_COUNT_H
+#define WINDOWED_COUNT_H
+#include "NGramCount.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+// a decayed score is renormalized once its weight passes e^this
+const double DECAY_RENORMALIZE = 300.0;
+// decayed scores below this are dropped when renormalizing
+const double DECAY_PRUNE = 1e-3;
+// shortest epoch or half life accepted, in seconds, so epoch
+// numbers stay far from overflowing
+const double WINDOW_MIN_EPOCH = 1e-3;
+// most epochs a window can be split into
+const size_t WINDOW_MAX_EPOCHS = 1 << 16;
+
+class WindowedCount
+{
+private:
+    typedef std::unordered_map<string, uint64_t, WordHash> Totals;
+
+    // words added during one epoch and how many times, keyed by
+    // their entry in totals; entries never move while a delta
+    // refers to them, since a word with a delta is never erased
+    typedef std::unordered_map<Totals::value_type *, uint64_t> Delta;
+
+    double epochLength;
+    vector<Delta> ring;
+    Totals totals;
+    int64_t epoch;
+    uint64_t total;
+
+    void retire(Delta &delta);
+
+public:
+    WindowedCount(double window, size_t epochs);
+
+    void add(const string &word, double now);
+    void advance(double now);
+
+    uint64_t count(const string &word) const;
+    uint64_t totalCount() const;
+    size_t size() const;
+    vector<std::pair<string, uint64_t>> top(size_t k) const;
+    void display(size_t limit) const;
+};
+
+class DecayedCount
+{
+private:
+    std::unordered_map<string, double, WordHash> scores;
+    double rate;
+    double origin;
+    double lastTime;
+    double weight;
+
+    void renormalize(double now);
+
+public:
+    explicit DecayedCount(double halfLife);
+
+    void add(const string &word, double now);
+
+    double score(const string &word, double now) const;
+    size_t size() const;
+    vector<std::pair<string, double>> top(size_t k, double now) const;
+    void display(size_t limit, double now) const;
+};
+
+void streamWindowed(const string &filename, double window, size_t epochs, double halfLife, size_t limit);
+
+#endif
@@ -0,0 +1,107 @@
+//##########################################################
+// File: WordBuffer.cpp
+// Description: This file contains the class implementation
+//			 for WordBuffer
+//##########################################################
+
+#include "WordBuffer.h"
+#include "Hash.h"
+
+// ##########################################################
+// @par Name
+// WordBuffer
+// @purpose
+// creates an empty buffer
+// @param [in] :
+// size_t numSlots - number of slots, rounded up to a power
+//				 of two
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+WordBuffer::WordBuffer(size_t numSlots) : used(0)
+{
+    size_t size = 16;
+    while (size < numSlots)
+	   size <<= 1;
+    this->slots.resize(size, Slot{string(), 0, 0});
+}
+
+// ##########################################################
+// @par Name
+// add
+// @purpose
+// adds one occurrence of a word to the buffer
+// @param [in] :
+// const string &word - word to be buffered
+// @return
+// bool - true once the buffer is full and should be flushed
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool WordBuffer::add(const string &word)
+{
+    return add(word, hashWord(word));
+}
+
+// ##########################################################
+// @par Name
+// add
+// @purpose
+// adds one occurrence of an already hashed word to the buffer
+// @param [in] :
+// const string &word - word to be buffered
+// uint64_t hash - hashWord of the word
+// @return
+// bool - true once the buffer is full and should be flushed
+// @par References
+// None
+// @par Notes
+// linear probing; a repeated word only bumps its count, so
+// with Zipfian text most calls never leave the table
+//###########################################################
+bool WordBuffer::add(const string &word, uint64_t hash)
+{
+    size_t mask = this->slots.size() - 1;
+    size_t i = hash & mask;
+    while (this->slots[i].count > 0)
+    {
+	   Slot &slot = this->slots[i];
+	   if (slot.hash == hash && slot.word == word)
+	   {
+		  slot.count++;
+		  return false;
+	   }
+	   i = (i + 1) & mask;
+    }
+
+    Slot &slot = this->slots[i];
+    slot.word.assign(word);
+    slot.hash = hash;
+    slot.count = 1;
+    return ++this->used * 2 >= this->slots.size();
+}
+
+// ##########################################################
+// @par Name
+// isEmpty
+// @purpose
+// determines if any words are waiting to be flushed
+// @param [in] :
+// None
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+bool WordBuffer::isEmpty() const
+{
+    return this->used == 0;
+}
@@ -0,0 +1,83 @@
+//##########################################################
+// File: WordBuffer.h
+// Description: This file contains the class definition for
+//			 WordBuffer, a small hash table that adds up
+//			 repeated words before they reach a tree
+//##########################################################
+
+#ifndef WORD_BUFFER_H
+#define WORD_BUFFER_H
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using std::string;
+
+// slots in the buffer, a power of two small enough to stay in
+// cache; the buffer reports full at half occupancy
+const size_t WORD_BUFFER_SLOTS = 1024;
+
+class WordBuffer
+{
+private:
+    struct Slot
+    {
+	   string word;
+	   uint64_t hash;
+	   uint64_t count;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<Slot *> order;
+    size_t used;
+
+public:
+    explicit WordBuffer(size_t numSlots = WORD_BUFFER_SLOTS);
+
+    bool add(const string &word);
+    bool add(const string &word, uint64_t hash);
+    bool isEmpty() const;
+
+    template<class Sink>
+    void flush(Sink sink);
+};
+
+// ##########################################################
+// @par Name
+// flush
+// @purpose
+// hands every buffered word and its count to the sink and
+// empties the buffer
+// @param [in] :
+// Sink sink - callable taking (const string &, uint64_t hash,
+//			 uint64_t count)
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the most frequent words are handed over first so new tree
+// nodes for hot words are allocated next to each other. The
+// slot strings keep their storage so refilling the buffer
+// does not allocate again
+//###########################################################
+template<class Sink>
+void WordBuffer::flush(Sink sink)
+{
+    this->order.clear();
+    for (Slot &slot : this->slots)
+	   if (slot.count > 0)
+		  this->order.push_back(&slot);
+    std::sort(this->order.begin(), this->order.end(), [](const Slot *a, const Slot *b) { return a->count > b->count; });
+
+    for (Slot *slot : this->order)
+    {
+	   sink(slot->word, slot->hash, slot->count);
+	   slot->count = 0;
+    }
+    this->used = 0;
+}
+
+#endif
@@ -7,6 +7,14 @@
 //##########################################################
 
 #include "WordCount.h"
+#include "Hash.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <unistd.h>
 
 // ##########################################################
 // @par Name
@@ -15,6 +23,7 @@
 // creates an instance of a WordCount type with a given filename
 // @param [in] :
 // string fn - name of file to be read from
+// Backend b - structure the words are counted in
 // @return
 // None
 // @par References
@@ -22,7 +31,66 @@
 // @par Notes
 // None
 //###########################################################
-WordCount::WordCount(const string &fn) : words(new AVLTree<string> ("WORD NOT FOUND")), filename(fn) {}
+WordCount::WordCount(const string &fn, Backend b)
+    : words("WORD NOT FOUND"), backend(b), filename(fn), memoryBudget(0), tableBytes(0), profiler(nullptr),
+      pruneLimit(0), pruneFloor(2), gatherStats(false), textTotals()
+{
+    if (this->backend == SKETCH)
+	   this->approx.reset(new ApproximateCount());
+}
+
+// ##########################################################
+// @par Name
+// WordCount
+// @purpose
+// creates a deep copy of an existing WordCount
+// @param [in] :
+// const WordCount &other - WordCount to be copied
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// moves are defaulted and cost O(1), so prefer them when
+// handing counts between stages. The hot word cache points
+// into the other tree, so the copy starts with an empty one.
+// Spilled counts are read only and shared between copies
+//###########################################################
+WordCount::WordCount(const WordCount &other)
+    : words(other.words), compact(other.compact), splay(other.splay), radix(other.radix),
+      approx(other.approx ? new ApproximateCount(*other.approx) : nullptr),
+      ngrams(other.ngrams ? new NGramCount(*other.ngrams) : nullptr),
+      positions(other.positions ? new PositionIndex(*other.positions) : nullptr),
+      pending(other.pending), cache(other.cache.capacity()), backend(other.backend), filename(other.filename),
+      memoryBudget(other.memoryBudget), tableBytes(other.tableBytes), spillDir(other.spillDir),
+      spilled(other.spilled),
+      chunks(other.chunks ? new ChunkCache(other.chunks->directory(), other.chunks->sizeLimit()) : nullptr),
+      profiler(other.profiler), pruneLimit(other.pruneLimit), pruneFloor(other.pruneFloor),
+      gatherStats(other.gatherStats), textTotals(other.textTotals) {}
+
+// ##########################################################
+// @par Name
+// operator=
+// @purpose
+// replaces the counts of this WordCount with a deep copy
+// @param [in] :
+// const WordCount &other - WordCount to be copied
+// @return
+// WordCount &
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+WordCount &WordCount::operator=(const WordCount &other)
+{
+    if (this != &other)
+    {
+	   WordCount copy(other);
+	   *this = std::move(copy);
+    }
+    return *this;
+}
 
 // ##########################################################
 // @par Name
@@ -33,33 +101,366 @@ WordCount::WordCount(const string &fn) : words(new AVLTree<string> ("WORD NOT FO
 // @param [in] :
 // None
 // @return
-// None
+// bool - false if the file could not be read or its spilled
+//	    counts could not be merged, leaving the counts partial
 // @par References
 // None
 // @par Notes
-// None
+// the file is prefetched in large blocks by a BlockReader, so
+// the next blocks are being read, and decompressed for gzip or
+// zstd files, while this one is tokenized and counted. With a
+// memory budget the counts may end up in a spilled count file
+// instead of the tree. With a chunk cache the text is split
+// into content defined chunks and only chunks not seen before
+// are tokenized; the counts of the others are read back from
+// the cache. N-grams, positions and the sketch need every
+// word in order, so they always tokenize the whole file
 //###########################################################
-void WordCount::read()
+bool WordCount::read()
 {
-    ifstream file;
-    string wordToAdd{};
-    file.open(this->filename);
+    BlockReader file(this->filename);
+    if (!file.isOpen())
+    {
+	   cout << "File failed to open" << endl;
+	   return false;
+    }
+    if (!file.isSupported())
+    {
+	   cout << Decompressor::name(file.compression()) << " input is not supported by this build" << endl;
+	   return false;
+    }
 
-    if (file.is_open())
+    this->cache.sync(this->words.generation());
+    const char *block;
+    size_t len;
+    auto next = [this, &file, &block, &len]()
     {
-	   while (!file.eof())
+	   ProfileScope scope(this->profiler, PHASE_READ);
+	   TraceSpan span("wait for block");
+	   return file.next(block, len);
+    };
+    if (this->chunks && this->backend != SKETCH && !this->ngrams && !this->positions && !this->gatherStats)
+    {
+	   ContentChunker chunker;
+	   auto add = [this](const char *chunk, size_t size)
+	   {
+		  TraceSpan span("count chunk");
+		  this->chunks->count(chunk, size, [this](const string &word, uint64_t count)
+		  {
+			 this->addCount(word, hashWord(word), count);
+			 if (this->profiler != nullptr)
+				this->profiler->addTokens(count);
+		  });
+		  this->checkBudget();
+	   };
+	   while (next())
 	   {
-		  getline(file, wordToAdd, ' ');
-		  wordToAdd.erase(remove_if(wordToAdd.begin(), wordToAdd.end(), ispunct), wordToAdd.end());
-		  wordToAdd.erase(remove_if(wordToAdd.begin(), wordToAdd.end(), isblank), wordToAdd.end());
-		  this->words->insert(wordToAdd);
+		  ProfileScope scope(this->profiler, PHASE_INSERT);
+		  chunker.feed(block, len, add);
 	   }
+	   ProfileScope scope(this->profiler, PHASE_INSERT);
+	   chunker.finish(add);
+	   this->chunks->evict();
     }
     else
     {
-	   cout << "File failed to open" << endl;
+	   Tokenizer tokenizer;
+	   tokenizer.countStats(this->gatherStats);
+	   auto add = [this](const string &word, uint64_t offset, uint64_t line)
+	   {
+		  if (this->positions)
+		  {
+			 this->positions->add(this->compact.insert(word), offset, line);
+			 if (this->ngrams)
+				this->ngrams->add(word);
+		  }
+		  else
+			 this->countWord(word);
+	   };
+	   if (this->profiler == nullptr)
+	   {
+		  while (next())
+		  {
+			 TraceSpan span("count block");
+			 tokenizer.feed(block, len, add);
+		  }
+		  tokenizer.finish(add);
+	   }
+	   else
+	   {
+		  // when profiling, each block is tokenized whole before
+		  // its words are counted so the two phases are timed
+		  // apart; the strings are reused from block to block
+		  struct Token
+		  {
+			 string word;
+			 uint64_t offset;
+			 uint64_t line;
+		  };
+		  std::vector<Token> tokens;
+		  size_t used = 0;
+		  auto collect = [&tokens, &used](const string &word, uint64_t offset, uint64_t line)
+		  {
+			 if (used == tokens.size())
+				tokens.push_back(Token{word, offset, line});
+			 else
+			 {
+				tokens[used].word.assign(word);
+				tokens[used].offset = offset;
+				tokens[used].line = line;
+			 }
+			 used++;
+		  };
+		  auto insert = [this, &tokens, &used, &add]()
+		  {
+			 ProfileScope scope(this->profiler, PHASE_INSERT);
+			 TraceSpan span("insert block");
+			 for (size_t i = 0; i < used; i++)
+				add(tokens[i].word, tokens[i].offset, tokens[i].line);
+			 this->profiler->addTokens(used);
+			 used = 0;
+		  };
+		  while (next())
+		  {
+			 {
+				ProfileScope scope(this->profiler, PHASE_TOKENIZE);
+				TraceSpan span("tokenize block");
+				tokenizer.feed(block, len, collect);
+			 }
+			 insert();
+		  }
+		  {
+			 ProfileScope scope(this->profiler, PHASE_TOKENIZE);
+			 tokenizer.finish(collect);
+		  }
+		  insert();
+	   }
+	   this->textTotals = tokenizer.stats();
+	   ProfileScope scope(this->profiler, PHASE_INSERT);
+	   flushPending();
+    }
+    ProfileScope scope(this->profiler, PHASE_INSERT);
+    if (this->backend == COMPACT_AVL)
+	   this->compact.shrinkToFit();
+    if (!this->runs.empty() && !mergeRuns())
+	   return false;
+
+    if (file.failed())
+    {
+	   cout << "File could not be read completely" << endl;
+	   return false;
+    }
+    return true;
+}
+
+// ##########################################################
+// @par Name
+// countWord
+// @purpose
+// adds one occurrence of a word to the selected backend
+// @param [in] :
+// const string &word - cleaned word read from the file
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the AVL backend first checks the hot word cache, which counts
+// a frequent word without walking the tree, then collects the
+// rest in a WordBuffer so a repeated word walks the tree once
+// per flush instead of once per occurrence. The compact tree
+// uses the buffer only. The radix tree is cheaper to walk
+// than the buffer is to probe, so it is updated directly, and
+// the splay tree is too since batching would hide the skew it
+// adapts to
+//###########################################################
+void WordCount::countWord(const string &word)
+{
+    if (this->backend == RADIX_TREE)
+	   this->radix.insert(word);
+    else if (this->backend == SPLAY_TREE)
+	   this->splay.insert(word);
+    else if (this->backend == SKETCH)
+	   this->approx->add(word);
+    else if (this->backend == COMPACT_AVL)
+    {
+	   if (this->pending.add(word))
+		  flushPending();
+    }
+    else
+    {
+	   uint64_t hash = hashWord(word);
+	   AVLNode<string, NodeCount> *node = this->cache.hit(word, hash);
+	   if (node != nullptr)
+		  this->words.addCount(node, 1);
+	   else if (this->pending.add(word, hash))
+		  flushPending();
+    }
+    if (this->ngrams)
+	   this->ngrams->add(word);
+}
+
+// ##########################################################
+// @par Name
+// addCount
+// @purpose
+// adds several occurrences of a word to the selected tree
+// @param [in] :
+// const string &word - cleaned word read from the file
+// uint64_t hash - hashWord of the word
+// uint64_t count - occurrences to add
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// every node inserted into the pointer based tree is offered
+// to the hot word cache
+//###########################################################
+void WordCount::addCount(const string &word, uint64_t hash, uint64_t count)
+{
+    if (this->backend == RADIX_TREE)
+	   this->radix.insert(word, count);
+    else if (this->backend == SPLAY_TREE)
+	   this->splay.insert(word, count);
+    else if (this->backend == COMPACT_AVL)
+	   this->compact.insert(word, count);
+    else
+    {
+	   size_t before = this->words.size();
+	   AVLNode<string, NodeCount> *node = this->words.insert(word, count);
+	   if (this->words.size() != before)
+		  this->tableBytes += sizeof(AVLNode<string, NodeCount>) + heapBytes(node->element);
+	   this->cache.admit(hash, node, count);
+    }
+}
+
+// ##########################################################
+// @par Name
+// flushPending
+// @purpose
+// adds the buffered words to the selected AVL tree
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void WordCount::flushPending()
+{
+    TraceSpan span("insert batch");
+    this->pending.flush([this](const string &word, uint64_t hash, uint64_t count) { this->addCount(word, hash, count); });
+    checkBudget();
+}
+
+// ##########################################################
+// @par Name
+// checkBudget
+// @purpose
+// spills the tree once its new nodes reach the memory budget
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// only the pointer based tree spills
+//###########################################################
+void WordCount::checkBudget()
+{
+    if (this->pruneLimit > 0 && treeSize() > this->pruneLimit)
+	   trim();
+    if (this->backend == AVL_TREE && this->memoryBudget > 0 && this->tableBytes >= this->memoryBudget)
+	   spill();
+}
+
+// ##########################################################
+// @par Name
+// trim
+// @purpose
+// prunes the tree to three quarters of the prune limit
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// words below the floor are dropped first; while that is not
+// enough the floor doubles. The floor is kept for the next
+// trim so a stream that keeps growing does not rescan the tree
+// at every low floor again
+//###########################################################
+void WordCount::trim()
+{
+    TraceSpan span("prune");
+    size_t target = this->pruneLimit - this->pruneLimit / 4;
+    while (treeSize() > target)
+    {
+	   removeWhere([this](const string &, uint64_t count) { return count < this->pruneFloor; });
+	   if (treeSize() > target)
+		  this->pruneFloor *= 2;
     }
-    file.close();
+}
+
+// ##########################################################
+// @par Name
+// treeSize
+// @purpose
+// gets the number of distinct words held by the tree that can
+// be pruned
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t WordCount::treeSize() const
+{
+    return this->backend == SPLAY_TREE ? this->splay.size() : this->words.size();
+}
+
+// ##########################################################
+// @par Name
+// removeWhere
+// @purpose
+// removes the words the predicate selects in one pass over the
+// tree
+// @param [in] :
+// Predicate shouldRemove - callable taking (const string &,
+//					  uint64_t count)
+// @return
+// size_t - number of words removed
+// @par References
+// None
+// @par Notes
+// the hot word cache is emptied since it may point at removed
+// nodes, and the bytes of removed nodes leave the budget
+//###########################################################
+template<class Predicate>
+size_t WordCount::removeWhere(Predicate shouldRemove)
+{
+    if (this->backend == SPLAY_TREE)
+	   return this->splay.removeIf(shouldRemove);
+
+    size_t freed = 0;
+    size_t removed = this->words.removeIf([&shouldRemove, &freed](const string &word, uint64_t count)
+    {
+	   if (!shouldRemove(word, count))
+		  return false;
+	   freed += sizeof(AVLNode<string, NodeCount>) + heapBytes(word);
+	   return true;
+    });
+    this->tableBytes -= std::min(freed, this->tableBytes);
+    this->cache.sync(this->words.generation());
+    return removed;
 }
 
 // ##########################################################
@@ -80,5 +481,860 @@ void WordCount::read()
 //###########################################################
 const void WordCount::display() const
 {
-    this->words->printTree();
+    if (this->spilled)
+    {
+	   CountFileReader file(*this->spilled);
+	   string word;
+	   uint64_t count;
+	   while (file.next(word, count))
+		  cout << word << " - " << count << endl;
+    }
+    else if (this->backend == RADIX_TREE)
+	   this->radix.printTree();
+    else if (this->backend == SKETCH)
+	   this->approx->display();
+    else if (this->backend == COMPACT_AVL)
+	   this->compact.printTree();
+    else if (this->backend == SPLAY_TREE)
+	   this->splay.printTree();
+    else
+	   this->words.printTree();
+}
+
+// ##########################################################
+// @par Name
+// displayByCount
+// @purpose
+// displays the words from most to least frequent, words with
+// the same count alphabetically
+// @param [in] :
+// size_t limit - most words to display, 0 for all of them
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the words are copied in alphabetical order into a flat
+// CountSnapshot, whose ranking is a parallel stable sort on
+// the counts, so ties stay alphabetical. The sketch keeps its
+// own ranking and displays that
+//###########################################################
+void WordCount::displayByCount(size_t limit) const
+{
+    CountSnapshot snap;
+    if (!fillSnapshot(snap))
+    {
+	   display();
+	   return;
+    }
+
+    string line;
+    snap.topK(limit == 0 ? snap.size() : limit, [&line](std::string_view word, uint64_t count)
+    {
+	   line.assign(word.data(), word.size());
+	   line += " - ";
+	   line += std::to_string(count);
+	   line += '\n';
+	   cout << line;
+    });
+    cout.flush();
+}
+
+// ##########################################################
+// @par Name
+// displayPrefix
+// @purpose
+// displays every word starting with a prefix and the number
+// of times it appears in the text file
+// @param [in] :
+// const string &prefix - prefix the words must start with
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// prefix queries need the radix tree backend
+//###########################################################
+void WordCount::displayPrefix(const string &prefix) const
+{
+    if (this->backend == RADIX_TREE)
+	   this->radix.printPrefix(prefix);
+    else
+	   cout << "Prefix queries require the radix tree backend" << endl;
+}
+
+// ##########################################################
+// @par Name
+// displayNGrams
+// @purpose
+// displays the n-grams counted while reading from most to
+// least frequent
+// @param [in] :
+// size_t limit - most n-grams to display, 0 for all of them
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// countNGrams must be called before read
+//###########################################################
+void WordCount::displayNGrams(size_t limit) const
+{
+    if (this->ngrams)
+	   this->ngrams->display(limit);
+    else
+	   cout << "N-gram counting was not enabled" << endl;
+}
+
+// ##########################################################
+// @par Name
+// displayPositions
+// @purpose
+// displays where each of several words appears in the text
+// file
+// @param [in] :
+// const std::vector<string> &list - words to be searched for
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// indexPositions must be called before read. The file is read
+// once however many words are asked about
+//###########################################################
+void WordCount::displayPositions(const std::vector<string> &list) const
+{
+    if (!this->positions)
+    {
+	   cout << "Position indexing was not enabled" << endl;
+	   return;
+    }
+    for (const string &word : list)
+	   this->positions->display(word, this->compact.find(word));
+}
+
+// ##########################################################
+// @par Name
+// contains
+// @purpose
+// determines if a word appears in the text file
+// @param [in] :
+// const string &word - word to be searched for
+// @return
+// bool
+// @par References
+// None
+// @par Notes
+// the sketch backend can report words that never appeared
+//###########################################################
+bool WordCount::contains(const string &word) const
+{
+    if (this->spilled)
+	   return count(word) > 0;
+    if (this->backend == RADIX_TREE)
+	   return this->radix.contains(word);
+    if (this->backend == SKETCH)
+	   return this->approx->estimate(word) > 0;
+    if (this->backend == COMPACT_AVL)
+	   return this->compact.contains(word);
+    if (this->backend == SPLAY_TREE)
+	   return this->splay.contains(word);
+    return this->words.contains(word);
+}
+
+// ##########################################################
+// @par Name
+// count
+// @purpose
+// gets the number of times a word appears in the text file
+// @param [in] :
+// const string &word - word to be searched for
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// the sketch backend can overestimate
+//###########################################################
+uint64_t WordCount::count(const string &word) const
+{
+    if (this->spilled)
+	   return countSpilled(std::vector<string>(1, word))[0];
+    if (this->backend == RADIX_TREE)
+	   return this->radix.count(word);
+    if (this->backend == SKETCH)
+	   return this->approx->estimate(word);
+    if (this->backend == COMPACT_AVL)
+	   return this->compact.count(word);
+    if (this->backend == SPLAY_TREE)
+	   return this->splay.count(word);
+
+    auto entry = this->words.lookup(word);
+    return entry ? entry->wordCount : 0;
+}
+
+// ##########################################################
+// @par Name
+// count
+// @purpose
+// gets the number of times each of a list of words appears
+// in the text file
+// @param [in] :
+// const std::vector<string> &queries - words to be searched for
+// @return
+// std::vector<uint64_t>
+// @par References
+// None
+// @par Notes
+// counts line up with queries. The AVL backend answers the
+// whole list in one walk of the tree
+//###########################################################
+std::vector<uint64_t> WordCount::count(const std::vector<string> &queries) const
+{
+    if (this->spilled)
+	   return countSpilled(queries);
+
+    std::vector<uint64_t> counts(queries.size());
+    if (this->backend != AVL_TREE)
+    {
+	   for (size_t i = 0; i < queries.size(); i++)
+		  counts[i] = count(queries[i]);
+	   return counts;
+    }
+
+    auto entries = this->words.lookup(queries);
+    for (size_t i = 0; i < entries.size(); i++)
+	   counts[i] = entries[i] ? entries[i]->wordCount : 0;
+    return counts;
+}
+
+// ##########################################################
+// @par Name
+// prefixCount
+// @purpose
+// gets the total number of times words starting with a
+// prefix appear in the text file
+// @param [in] :
+// const string &prefix - prefix the words must start with
+// @return
+// uint64_t
+// @par References
+// None
+// @par Notes
+// returns 0 for backends without prefix support
+//###########################################################
+uint64_t WordCount::prefixCount(const string &prefix) const
+{
+    return this->backend == RADIX_TREE ? this->radix.prefixCount(prefix) : 0;
+}
+
+// ##########################################################
+// @par Name
+// memoryUsage
+// @purpose
+// estimates the bytes held by the counting structure
+// @param [in] :
+// None
+// @return
+// size_t
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+size_t WordCount::memoryUsage() const
+{
+    if (this->backend == RADIX_TREE)
+	   return this->radix.memoryUsage();
+    if (this->backend == SKETCH)
+	   return this->approx->memoryUsage();
+    if (this->backend == COMPACT_AVL)
+	   return this->compact.memoryUsage();
+    if (this->backend == SPLAY_TREE)
+	   return this->splay.memoryUsage();
+    return this->words.memoryUsage();
+}
+
+// ##########################################################
+// @par Name
+// setSketchParameters
+// @purpose
+// resizes the sketches used by the SKETCH backend
+// @param [in] :
+// double epsilon - overestimate allowed on each word count as
+//			 a fraction of the total word count
+// double delta - probability a word count exceeds that bound
+// size_t topK - number of most frequent words tracked
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// discards anything counted so far
+//###########################################################
+void WordCount::setSketchParameters(double epsilon, double delta, size_t topK)
+{
+    this->approx.reset(new ApproximateCount(epsilon, delta, topK));
+}
+
+// ##########################################################
+// @par Name
+// countNGrams
+// @purpose
+// makes read also count runs of n consecutive words
+// @param [in] :
+// unsigned n - words per n-gram, at most MAX_NGRAM
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// words are interned to integer ids and each n-gram is keyed
+// by its packed ids rather than by its text
+//###########################################################
+void WordCount::countNGrams(unsigned n)
+{
+    this->ngrams.reset(new NGramCount(n));
+}
+
+// ##########################################################
+// @par Name
+// indexPositions
+// @purpose
+// makes read also record where every word appears
+// @param [in] :
+// PositionMode mode - record byte offsets and lines, or only
+//			     lines
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// positions are delta and varint encoded per word, so a
+// concordance query decodes one posting list instead of
+// rescanning the file. The lists are keyed by the index of the
+// word's node in the compact tree, so the words are counted
+// there whatever backend was chosen
+//###########################################################
+void WordCount::indexPositions(PositionMode mode)
+{
+    this->positions.reset(new PositionIndex(mode));
+    this->backend = COMPACT_AVL;
+}
+
+// ##########################################################
+// @par Name
+// setCacheSize
+// @purpose
+// sets the number of slots in the hot word cache
+// @param [in] :
+// size_t slots - slots in the cache, 0 disables it
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// only the AVL backend uses the cache
+//###########################################################
+void WordCount::setCacheSize(size_t slots)
+{
+    this->cache.resize(slots);
+}
+
+// ##########################################################
+// @par Name
+// displayCacheStats
+// @purpose
+// displays how many words the hot word cache counted
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+void WordCount::displayCacheStats() const
+{
+    cout << "cache slots - " << this->cache.capacity() << endl;
+    cout << "cache hits - " << this->cache.hitCount() << endl;
+    cout << "cache misses - " << this->cache.missCount() << endl;
+    cout << "cache hit rate - " << std::fixed << std::setprecision(2) << this->cache.hitRate() * 100 << "%" << endl;
+    if (this->chunks)
+	   this->chunks->display();
+}
+
+// ##########################################################
+// @par Name
+// setMemoryBudget
+// @purpose
+// limits the memory the AVL tree may use before its counts are
+// spilled to disk
+// @param [in] :
+// size_t bytes - budget for the tree, 0 for no limit
+// const string &dir - directory for spill files, the system
+//				 temporary directory if empty
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// only the AVL backend spills. The read ring is taken off the
+// budget and the tree gets the rest, but never less than
+// MIN_TABLE_BUDGET
+//###########################################################
+void WordCount::setMemoryBudget(size_t bytes, const string &dir)
+{
+    size_t ring = READ_BLOCK_SIZE * READ_DEPTH;
+    if (bytes == 0)
+	   this->memoryBudget = 0;
+    else
+	   this->memoryBudget = bytes > ring + MIN_TABLE_BUDGET ? bytes - ring : MIN_TABLE_BUDGET;
+    if (!dir.empty())
+	   this->spillDir = dir;
+    else
+    {
+	   std::error_code error;
+	   this->spillDir = std::filesystem::temp_directory_path(error).string();
+	   if (error)
+		  this->spillDir = ".";
+    }
+}
+
+// ##########################################################
+// @par Name
+// setChunkCache
+// @purpose
+// makes read keep the word counts of each chunk of the file
+// in a directory and reuse them on later reads
+// @param [in] :
+// const string &dir - directory for the chunk counts, empty to
+//			     stop caching
+// uint64_t maxBytes - size of entries the directory is kept
+//				near once read finishes
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// chunks are keyed by their content, so a file that only had
+// lines appended or edited reuses every chunk away from the
+// changes, and files sharing text share entries. Past the
+// limit the entries used longest ago that this read did not
+// need are removed
+//###########################################################
+void WordCount::setChunkCache(const string &dir, uint64_t maxBytes)
+{
+    if (dir.empty())
+	   this->chunks.reset();
+    else
+	   this->chunks.reset(new ChunkCache(dir, maxBytes));
+}
+
+// ##########################################################
+// @par Name
+// setProfiler
+// @purpose
+// makes read report the time and counters of its read,
+// tokenize and insert phases to a profiler
+// @param [in] :
+// PhaseProfiler *p - profiler to report to, null to stop
+//				   profiling
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the profiler is not owned and must outlive the reads; copies
+// of this WordCount report to the same one
+//###########################################################
+void WordCount::setProfiler(PhaseProfiler *p)
+{
+    this->profiler = p;
+}
+
+// ##########################################################
+// @par Name
+// setPruneLimit
+// @purpose
+// caps the number of distinct words kept while reading by
+// dropping rare words whenever the cap is passed
+// @param [in] :
+// size_t maxWords - most distinct words to keep, 0 to never
+//				 prune
+// uint64_t minCount - count a word needs to survive the first
+//				   prune; raised when that is not enough
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// pruned words start over from 0 if they are seen again, so
+// with a cap the counts of rare words are lower bounds. Only
+// the avl and splay backends can be pruned
+//###########################################################
+void WordCount::setPruneLimit(size_t maxWords, uint64_t minCount)
+{
+    if (maxWords > 0 && this->backend != AVL_TREE && this->backend != SPLAY_TREE)
+    {
+	   cout << "Pruning requires the avl or splay backend" << endl;
+	   return;
+    }
+    this->pruneLimit = maxWords;
+    this->pruneFloor = minCount > 0 ? minCount : 1;
+}
+
+// ##########################################################
+// @par Name
+// prune
+// @purpose
+// removes every word counted fewer than minCount times
+// @param [in] :
+// uint64_t minCount - smallest count kept
+// @return
+// size_t - number of words removed
+// @par References
+// None
+// @par Notes
+// one linear pass that rebuilds the tree balanced, instead of
+// a remove per word. Counts already spilled to disk are kept
+//###########################################################
+size_t WordCount::prune(uint64_t minCount)
+{
+    if (this->backend != AVL_TREE && this->backend != SPLAY_TREE)
+    {
+	   cout << "Pruning requires the avl or splay backend" << endl;
+	   return 0;
+    }
+    TraceSpan span("prune");
+    return removeWhere([minCount](const string &, uint64_t count) { return count < minCount; });
+}
+
+// ##########################################################
+// @par Name
+// removeWords
+// @purpose
+// removes every listed word, such as a list of stopwords
+// @param [in] :
+// const std::vector<string> &list - words to remove
+// @return
+// size_t - number of listed words that had been counted
+// @par References
+// None
+// @par Notes
+// the list is sorted once and merged against the walk of the
+// tree, so its length adds O(k log k) rather than k removes
+//###########################################################
+size_t WordCount::removeWords(const std::vector<string> &list)
+{
+    if (this->backend != AVL_TREE && this->backend != SPLAY_TREE)
+    {
+	   cout << "Pruning requires the avl or splay backend" << endl;
+	   return 0;
+    }
+    std::vector<string> sorted(list);
+    std::sort(sorted.begin(), sorted.end());
+    size_t next = 0;
+    return removeWhere([&sorted, &next](const string &word, uint64_t)
+    {
+	   while (next < sorted.size() && sorted[next] < word)
+		  next++;
+	   return next < sorted.size() && sorted[next] == word;
+    });
+}
+
+// ##########################################################
+// @par Name
+// setTextStats
+// @purpose
+// makes read also gather line, byte, character and word totals
+// like those of wc
+// @param [in] :
+// bool on - true to gather the totals
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// the totals come from the same pass over each block as the
+// words, so the file is still read once. The chunk cache is
+// skipped while they are gathered since cached chunks are
+// never scanned
+//###########################################################
+void WordCount::setTextStats(bool on)
+{
+    this->gatherStats = on;
+}
+
+// ##########################################################
+// @par Name
+// displayTextStats
+// @purpose
+// displays the totals gathered by the last read
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// words are counted as wc counts them, runs of non-whitespace;
+// tokens are the words after punctuation is removed, which is
+// what the other displays count
+//###########################################################
+void WordCount::displayTextStats() const
+{
+    cout << "lines - " << this->textTotals.lines << endl;
+    cout << "words - " << this->textTotals.words << endl;
+    cout << "chars - " << this->textTotals.chars << endl;
+    cout << "bytes - " << this->textTotals.bytes << endl;
+    cout << "longest line - " << this->textTotals.longestLine << endl;
+    cout << "tokens - " << this->textTotals.tokens << endl;
+}
+
+// ##########################################################
+// @par Name
+// runName
+// @purpose
+// makes a unique name for a spill file
+// @param [in] :
+// None
+// @return
+// string
+// @par References
+// None
+// @par Notes
+// None
+//###########################################################
+string WordCount::runName() const
+{
+    static std::atomic<unsigned> nextRun{0};
+    return this->spillDir + "/wordcount-" + std::to_string(getpid()) + "-" + std::to_string(nextRun++) + ".cnt";
+}
+
+// ##########################################################
+// @par Name
+// spill
+// @purpose
+// writes the tree to disk as a sorted run and empties it
+// @param [in] :
+// None
+// @return
+// None
+// @par References
+// None
+// @par Notes
+// if the run cannot be written the budget is dropped and
+// counting carries on in memory
+//###########################################################
+void WordCount::spill()
+{
+    TraceSpan span("spill");
+    string run = runName();
+    CountFileWriter writer(run);
+    this->words.forEach([&writer](const string &word, uint64_t count) { writer.write(word, count); });
+    if (!writer.close())
+    {
+	   cout << "Could not write spill file " << run << endl;
+	   std::remove(run.c_str());
+	   this->memoryBudget = 0;
+	   return;
+    }
+
+    this->runs.push_back(run);
+    this->words.makeEmpty();
+    this->cache.sync(this->words.generation());
+    this->tableBytes = 0;
+}
+
+// ##########################################################
+// @par Name
+// mergeRuns
+// @purpose
+// merges the spilled runs, the rest of the tree and any counts
+// spilled by an earlier read into one sorted count file
+// @param [in] :
+// None
+// @return
+// bool - false if the runs could not be merged
+// @par References
+// None
+// @par Notes
+// runs are merged MERGE_FAN_IN at a time so the number of open
+// files and their buffers stay bounded. The merged file is
+// deleted when the last WordCount sharing it goes away. An
+// input run is only deleted once it has been merged; on a
+// failure the runs left are kept and listed, since the tree
+// has already been emptied into them
+//###########################################################
+bool WordCount::mergeRuns()
+{
+    TraceSpan span("merge runs");
+    if (!this->words.isEmpty())
+	   spill();
+
+    std::vector<string> inputs;
+    inputs.swap(this->runs);
+    size_t extra = this->spilled ? 1 : 0;
+    bool merged = this->words.isEmpty();
+    while (merged && inputs.size() + extra > MERGE_FAN_IN)
+    {
+	   std::vector<string> group(inputs.begin(), inputs.begin() + MERGE_FAN_IN - extra);
+	   string run = runName();
+	   merged = mergeCountFiles(group, run);
+	   if (!merged)
+	   {
+		  std::remove(run.c_str());
+		  break;
+	   }
+	   for (const string &name : group)
+		  std::remove(name.c_str());
+	   inputs.erase(inputs.begin(), inputs.begin() + group.size());
+	   inputs.push_back(run);
+    }
+
+    string result = runName();
+    if (merged)
+    {
+	   std::vector<string> group = inputs;
+	   if (this->spilled)
+		  group.push_back(*this->spilled);
+	   merged = mergeCountFiles(group, result);
+    }
+
+    if (!merged)
+    {
+	   cout << "Spilled counts could not be merged, the runs are kept in" << endl;
+	   for (const string &name : inputs)
+		  cout << name << endl;
+	   std::remove(result.c_str());
+	   return false;
+    }
+    for (const string &name : inputs)
+	   std::remove(name.c_str());
+    this->spilled.reset(new string(result), [](const string *name)
+    {
+	   std::remove(name->c_str());
+	   delete name;
+    });
+    return true;
+}
+
+// ##########################################################
+// @par Name
+// countSpilled
+// @purpose
+// looks words up in the spilled count file
+// @param [in] :
+// const std::vector<string> &queries - words to be searched for
+// @return
+// std::vector<uint64_t>
+// @par References
+// None
+// @par Notes
+// the queries are sorted and matched against the sorted file
+// in a single pass that stops after the largest query
+//###########################################################
+std::vector<uint64_t> WordCount::countSpilled(const std::vector<string> &queries) const
+{
+    std::vector<uint64_t> counts(queries.size(), 0);
+    std::vector<size_t> order(queries.size());
+    for (size_t i = 0; i < order.size(); i++)
+	   order[i] = i;
+    std::sort(order.begin(), order.end(), [&queries](size_t a, size_t b) { return queries[a] < queries[b]; });
+
+    CountFileReader file(*this->spilled);
+    string word;
+    uint64_t count;
+    size_t next = 0;
+    while (next < order.size() && file.next(word, count))
+    {
+	   while (next < order.size() && queries[order[next]] < word)
+		  next++;
+	   while (next < order.size() && queries[order[next]] == word)
+		  counts[order[next++]] = count;
+    }
+    return counts;
+}
+
+// ##########################################################
+// @par Name
+// fillSnapshot
+// @purpose
+// copies the counts into a snapshot and finishes it
+// @param [in] :
+// None
+// @return
+// bool - false if the backend cannot list its words
+// @par References
+// CountSnapshot &snap - empty snapshot to be filled
+// @par Notes
+// with positions indexed every word's postings are attached
+// to it, still encoded
+//###########################################################
+bool WordCount::fillSnapshot(CountSnapshot &snap) const
+{
+    if (this->positions)
+	   this->compact.forEachIndexed([this, &snap](std::string_view word, uint64_t count, uint32_t n)
+	   {
+		  snap.add(word, count);
+		  snap.addPositions(*this->positions, n);
+	   });
+    else if (!forEachWord([&snap](const string &word, uint64_t count) { snap.add(word, count); }))
+	   return false;
+    snap.finish();
+    return true;
+}
+
+// ##########################################################
+// @par Name
+// forEachWord
+// @purpose
+// calls the visitor on every counted word and its count in
+// sorted order
+// @param [in] :
+// const std::function<void(const string &, uint64_t)> &visitor
+//				 - callable receiving each word and count
+// @return
+// bool - false if the backend cannot list its words
+// @par References
+// None
+// @par Notes
+// the sketch backend only keeps hashes, so it cannot list them
+//###########################################################
+bool WordCount::forEachWord(const std::function<void(const string &, uint64_t)> &visitor) const
+{
+    if (this->spilled)
+    {
+	   CountFileReader file(*this->spilled);
+	   string word;
+	   uint64_t count;
+	   while (file.next(word, count))
+		  visitor(word, count);
+	   return !file.failed();
+    }
+
+    string key;
+    switch (this->backend)
+    {
+    case AVL_TREE:
+	   this->words.forEach([&visitor](const string &word, uint64_t count) { visitor(word, count); });
+	   return true;
+    case RADIX_TREE:
+	   this->radix.forEach([&visitor](const string &word, uint64_t count) { visitor(word, count); });
+	   return true;
+    case SPLAY_TREE:
+	   this->splay.forEach([&visitor](const string &word, uint64_t count) { visitor(word, count); });
+	   return true;
+    case COMPACT_AVL:
+	   this->compact.forEach([&visitor, &key](std::string_view word, uint64_t count)
+	   {
+		  key.assign(word.data(), word.size());
+		  visitor(key, count);
+	   });
+	   return true;
+    default:
+	   return false;
+    }
 }
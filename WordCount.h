@@ -9,25 +9,129 @@
 #ifndef WORDCOUNT_H
 #define WORDCOUNT_H
 #include "AVLTree.h"
+#include "CompactAVLTree.h"
+#include "SplayTree.h"
+#include "RadixTree.h"
+#include "ApproximateCount.h"
+#include "NGramCount.h"
+#include "PositionIndex.h"
+#include "BlockReader.h"
+#include "Tokenizer.h"
+#include "WordBuffer.h"
+#include "HotCache.h"
+#include "CountFile.h"
+#include "ChunkCache.h"
+#include "CountSnapshot.h"
+#include "PhaseProfiler.h"
 #include <string>
-#include <fstream>
-#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
 
 using std::string;
-using std::ifstream;
-using std::remove_if;
+
+// width of the counts in the AVL tree's nodes. Counts that
+// outgrow it are promoted rather than wrapped, so a build with
+// -DWORDCOUNT_COUNT_BITS=16 gets smaller nodes for small keys
+// and 64 avoids the promotion table on huge corpora
+#if defined(WORDCOUNT_COUNT_BITS) && WORDCOUNT_COUNT_BITS == 16
+typedef uint16_t NodeCount;
+#elif defined(WORDCOUNT_COUNT_BITS) && WORDCOUNT_COUNT_BITS == 64
+typedef uint64_t NodeCount;
+#else
+typedef uint32_t NodeCount;
+#endif
+
+// most count files merged at once when spilled runs are merged
+const size_t MERGE_FAN_IN = 64;
+// smallest share of a memory budget left for the tree
+const size_t MIN_TABLE_BUDGET = 1 << 20;
+
+// structure used to count the words of a file
+enum Backend
+{
+    AVL_TREE,
+    RADIX_TREE,
+    SKETCH,
+    COMPACT_AVL,
+    SPLAY_TREE
+};
 
 class WordCount
 {
 private:
-    AVLTree<string> *words;
+    AVLTree<string, NodeCount> words;
+    CompactAVLTree<string> compact;
+    SplayTree<string> splay;
+    RadixTree radix;
+    std::unique_ptr<ApproximateCount> approx;
+    std::unique_ptr<NGramCount> ngrams;
+    std::unique_ptr<PositionIndex> positions;
+    WordBuffer pending;
+    HotCache<string, NodeCount> cache;
+    Backend backend;
     string filename;
 
+    size_t memoryBudget;
+    size_t tableBytes;
+    string spillDir;
+    std::vector<string> runs;
+    std::shared_ptr<const string> spilled;
+    std::unique_ptr<ChunkCache> chunks;
+    PhaseProfiler *profiler;
+    size_t pruneLimit;
+    uint64_t pruneFloor;
+    bool gatherStats;
+    TextStats textTotals;
+
+    void countWord(const string &word);
+    void addCount(const string &word, uint64_t hash, uint64_t count);
+    void flushPending();
+    void checkBudget();
+    void trim();
+    size_t treeSize() const;
+    template<class Predicate>
+    size_t removeWhere(Predicate shouldRemove);
+    string runName() const;
+    void spill();
+    bool mergeRuns();
+    std::vector<uint64_t> countSpilled(const std::vector<string> &queries) const;
+
 public:
-    WordCount(const string &fn);
+    WordCount(const string &fn, Backend b = AVL_TREE);
+    WordCount(const WordCount &other);
+    WordCount(WordCount &&other) noexcept = default;
+    WordCount &operator=(const WordCount &other);
+    WordCount &operator=(WordCount &&other) noexcept = default;
 
-    void read();
+    bool read();
     const void display() const;
+    void displayByCount(size_t limit = 0) const;
+    void displayPrefix(const string &prefix) const;
+    void displayNGrams(size_t limit = 0) const;
+    void displayPositions(const std::vector<string> &list) const;
+
+    bool contains(const string &word) const;
+    uint64_t count(const string &word) const;
+    std::vector<uint64_t> count(const std::vector<string> &queries) const;
+    uint64_t prefixCount(const string &prefix) const;
+    size_t memoryUsage() const;
+    bool forEachWord(const std::function<void(const string &, uint64_t)> &visitor) const;
+    bool fillSnapshot(CountSnapshot &snap) const;
+    void setSketchParameters(double epsilon, double delta, size_t topK);
+    void setCacheSize(size_t slots);
+    void setMemoryBudget(size_t bytes, const string &dir = "");
+    void setChunkCache(const string &dir, uint64_t maxBytes = CHUNK_CACHE_LIMIT);
+    void setProfiler(PhaseProfiler *p);
+    void setPruneLimit(size_t maxWords, uint64_t minCount = 2);
+    void setTextStats(bool on);
+    void displayTextStats() const;
+    size_t prune(uint64_t minCount);
+    size_t removeWords(const std::vector<string> &list);
+    void displayCacheStats() const;
+    void countNGrams(unsigned n);
+    void indexPositions(PositionMode mode);
 };
 
 #endif
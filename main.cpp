@@ -6,16 +6,328 @@
 //##################################################################
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <string>
-#include "BinaryTree.h"
+#include <vector>
+#include <memory>
 #include "WordCount.h"
+#include "Benchmark.h"
+#include "Server.h"
+#include "WindowedCount.h"
+#include "Trace.h"
+#include "QuerySet.h"
+#include "SampleEstimator.h"
+#include <csignal>
 
 using std::string;
 
-int main() {
-    WordCount testFile("WordCountTest.txt");
-    testFile.read();
-    testFile.display();
+// server stopped by SIGINT and SIGTERM
+static WordCountServer *activeServer = nullptr;
 
+static void stopServer(int)
+{
+    if (activeServer != nullptr)
+	   activeServer->stop();
+}
+
+int main(int argc, char *argv[]) {
+    string filename = "WordCountTest.txt";
+    string prefix;
+    string watchFile;
+    string queryFile;
+    bool hasPrefix = false;
+    bool bench = false;
+    Backend backend = AVL_TREE;
+    double epsilon = 0.0001;
+    size_t topK = 100;
+    unsigned ngram = 0;
+    bool hasNGram = false;
+    long cacheSlots = -1;
+    bool cacheStats = false;
+    bool byCount = false;
+    bool profile = false;
+    bool textStats = false;
+    double sampleFraction = 0;
+    uint64_t seed = 1;
+    uint64_t minCount = 0;
+    size_t pruneLimit = 0;
+    string stopwordFile;
+    string traceFile;
+    size_t budgetMB = 0;
+    string spillDir;
+    string socketPath;
+    string chunkDir;
+    uint64_t chunkLimitMB = CHUNK_CACHE_LIMIT >> 20;
+    double window = 0;
+    bool hasWindow = false;
+    size_t epochs = 6;
+    double halfLife = 0;
+    bool hasHalfLife = false;
+    std::vector<string> positionWords;
+    bool hasPositions = false;
+    PositionMode positionMode = POSITION_OFFSETS;
+
+    for (int i = 1; i < argc; i++)
+    {
+	   string arg = argv[i];
+	   if (arg == "--backend" && i + 1 < argc)
+	   {
+		  string name = argv[++i];
+		  if (name == "radix")
+			 backend = RADIX_TREE;
+		  else if (name == "sketch")
+			 backend = SKETCH;
+		  else if (name == "compact")
+			 backend = COMPACT_AVL;
+		  else if (name == "splay")
+			 backend = SPLAY_TREE;
+		  else
+			 backend = AVL_TREE;
+	   }
+	   else if (arg == "--epsilon" && i + 1 < argc)
+		  epsilon = std::stod(argv[++i]);
+	   else if (arg == "--topk" && i + 1 < argc)
+		  topK = std::stoul(argv[++i]);
+	   else if (arg == "--prefix" && i + 1 < argc)
+	   {
+		  prefix = argv[++i];
+		  hasPrefix = true;
+	   }
+	   else if (arg == "--ngram" && i + 1 < argc)
+	   {
+		  ngram = static_cast<unsigned>(std::stoul(argv[++i]));
+		  hasNGram = true;
+	   }
+	   else if (arg == "--watch" && i + 1 < argc)
+		  watchFile = argv[++i];
+	   else if (arg == "--query-set" && i + 1 < argc)
+		  queryFile = argv[++i];
+	   else if (arg == "--cache" && i + 1 < argc)
+		  cacheSlots = std::stol(argv[++i]);
+	   else if (arg == "--by-count")
+		  byCount = true;
+	   else if (arg == "--profile")
+		  profile = true;
+	   else if (arg == "--trace" && i + 1 < argc)
+		  traceFile = argv[++i];
+	   else if (arg == "--min-count" && i + 1 < argc)
+		  minCount = std::stoull(argv[++i]);
+	   else if (arg == "--prune-limit" && i + 1 < argc)
+		  pruneLimit = std::stoul(argv[++i]);
+	   else if (arg == "--stopwords" && i + 1 < argc)
+		  stopwordFile = argv[++i];
+	   else if (arg == "--sample" && i + 1 < argc)
+		  sampleFraction = std::stod(argv[++i]);
+	   else if (arg == "--seed" && i + 1 < argc)
+		  seed = std::stoull(argv[++i]);
+	   else if (arg == "--wc")
+		  textStats = true;
+	   else if (arg == "--cache-stats")
+		  cacheStats = true;
+	   else if (arg == "--memory-budget" && i + 1 < argc)
+		  budgetMB = std::stoul(argv[++i]);
+	   else if (arg == "--spill-dir" && i + 1 < argc)
+		  spillDir = argv[++i];
+	   else if (arg == "--window" && i + 1 < argc)
+	   {
+		  window = std::stod(argv[++i]);
+		  hasWindow = true;
+	   }
+	   else if (arg == "--epochs" && i + 1 < argc)
+		  epochs = std::stoul(argv[++i]);
+	   else if (arg == "--half-life" && i + 1 < argc)
+	   {
+		  halfLife = std::stod(argv[++i]);
+		  hasHalfLife = true;
+	   }
+	   else if (arg == "--chunk-cache" && i + 1 < argc)
+		  chunkDir = argv[++i];
+	   else if (arg == "--chunk-cache-limit" && i + 1 < argc)
+		  chunkLimitMB = std::stoull(argv[++i]);
+	   else if (arg == "--serve" && i + 1 < argc)
+		  socketPath = argv[++i];
+	   else if (arg == "--positions" && i + 1 < argc)
+	   {
+		  // a comma separated list, so one read answers them all
+		  std::stringstream list(argv[++i]);
+		  string word;
+		  while (std::getline(list, word, ','))
+			 if (!word.empty())
+				positionWords.push_back(word);
+		  hasPositions = true;
+	   }
+	   else if (arg == "--positions-mode" && i + 1 < argc)
+	   {
+		  positionMode = string(argv[++i]) == "lines" ? POSITION_LINES : POSITION_OFFSETS;
+		  hasPositions = true;
+	   }
+	   else if (arg == "--bench")
+		  bench = true;
+	   else
+		  filename = arg;
+    }
+
+    if (hasNGram && (ngram < 1 || ngram > MAX_NGRAM))
+    {
+	   cout << "N-gram size must be between 1 and " << MAX_NGRAM << endl;
+	   return 1;
+    }
+    if (backend == SKETCH && !(epsilon >= CountMinSketch::minEpsilon() && epsilon < 1))
+    {
+	   cout << "Epsilon must be at least " << CountMinSketch::minEpsilon() << " and below 1" << endl;
+	   return 1;
+    }
+    if (hasWindow && !(epochs >= 1 && epochs <= WINDOW_MAX_EPOCHS && window / epochs >= WINDOW_MIN_EPOCH))
+    {
+	   cout << "Window must be split into 1 to " << WINDOW_MAX_EPOCHS << " epochs of at least "
+		   << WINDOW_MIN_EPOCH << " seconds" << endl;
+	   return 1;
+    }
+    if (hasHalfLife && !(halfLife >= WINDOW_MIN_EPOCH))
+    {
+	   cout << "Half life must be at least " << WINDOW_MIN_EPOCH << " seconds" << endl;
+	   return 1;
+    }
+    // position indexing counts in the compact tree, which cannot
+    // be pruned either
+    bool pruning = minCount > 1 || pruneLimit > 0 || !stopwordFile.empty();
+    if (pruning && (hasPositions || (backend != AVL_TREE && backend != SPLAY_TREE)))
+    {
+	   cout << "Pruning requires the avl or splay backend" << endl;
+	   return 1;
+    }
+
+    if (bench)
+    {
+	   benchmarkBackends(filename);
+	   return 0;
+    }
+    if (hasWindow || hasHalfLife)
+    {
+	   streamWindowed(filename, window, epochs, halfLife, topK);
+	   return 0;
+    }
+
+    if (sampleFraction > 0)
+    {
+	   estimateSampled(filename, sampleFraction, topK, seed);
+	   return 0;
+    }
+    if (!queryFile.empty())
+    {
+	   std::ifstream list(queryFile);
+	   std::vector<string> queries;
+	   string word;
+	   while (list >> word)
+		  queries.push_back(word);
+
+	   std::vector<uint64_t> counts = countQuerySet(filename, queries);
+	   for (size_t i = 0; i < counts.size(); i++)
+		  cout << queries[i] << " - " << counts[i] << endl;
+	   return 0;
+    }
+
+    if (!socketPath.empty())
+    {
+	   WordCountServer server(socketPath, backend);
+	   if (hasPositions)
+		  server.indexPositions(positionMode);
+	   std::shared_ptr<const CountSnapshot> snap = WordCountServer::buildSnapshot(filename, backend, hasPositions,
+																			   positionMode);
+	   if (!snap || !server.start())
+	   {
+		  cout << "Server could not be started" << endl;
+		  return 1;
+	   }
+	   server.setSnapshot(snap);
+	   activeServer = &server;
+	   std::signal(SIGINT, stopServer);
+	   std::signal(SIGTERM, stopServer);
+	   server.run();
+	   activeServer = nullptr;
+	   return 0;
+    }
+
+    if (!traceFile.empty())
+    {
+	   TraceLog::enable();
+	   TraceLog::nameThread("main");
+    }
+    WordCount testFile(filename, backend);
+    if (backend == SKETCH)
+	   testFile.setSketchParameters(epsilon, 0.01, topK);
+    if (hasNGram)
+	   testFile.countNGrams(ngram);
+    if (hasPositions)
+	   testFile.indexPositions(positionMode);
+    if (cacheSlots >= 0)
+	   testFile.setCacheSize(static_cast<size_t>(cacheSlots));
+    if (budgetMB > 0)
+	   testFile.setMemoryBudget(budgetMB << 20, spillDir);
+    if (!chunkDir.empty())
+	   testFile.setChunkCache(chunkDir, chunkLimitMB << 20);
+    testFile.setTextStats(textStats);
+    if (pruneLimit > 0)
+	   testFile.setPruneLimit(pruneLimit, minCount > 1 ? minCount : 2);
+    std::unique_ptr<PhaseProfiler> profiler;
+    if (profile)
+    {
+	   profiler.reset(new PhaseProfiler());
+	   testFile.setProfiler(profiler.get());
+    }
+    if (!testFile.read())
+	   return 1;
+    if (!stopwordFile.empty())
+    {
+	   std::ifstream list(stopwordFile);
+	   std::vector<string> stopwords;
+	   string word;
+	   while (list >> word)
+		  stopwords.push_back(word);
+	   testFile.removeWords(stopwords);
+    }
+    if (minCount > 1)
+	   testFile.prune(minCount);
+    {
+	   ProfileScope scope(profiler.get(), PHASE_DISPLAY);
+	   TraceSpan span("display");
+	   if (cacheStats)
+		  testFile.displayCacheStats();
+	   else if (!watchFile.empty())
+	   {
+		  std::ifstream watch(watchFile);
+		  std::vector<string> queries;
+		  string word;
+		  while (watch >> word)
+			 queries.push_back(word);
+
+		  std::vector<uint64_t> counts = testFile.count(queries);
+		  for (size_t i = 0; i < queries.size(); i++)
+			 cout << queries[i] << " - " << counts[i] << endl;
+	   }
+	   else if (hasPositions)
+		  testFile.displayPositions(positionWords);
+	   else if (hasNGram)
+		  testFile.displayNGrams(topK);
+	   else if (hasPrefix)
+	   {
+		  testFile.displayPrefix(prefix);
+		  cout << "total - " << testFile.prefixCount(prefix) << endl;
+	   }
+	   else if (byCount)
+		  testFile.displayByCount();
+	   else
+		  testFile.display();
+	   if (textStats)
+		  testFile.displayTextStats();
+    }
+
+    // the report goes to stderr so the counts can still be
+    // redirected and compared
+    if (profiler)
+	   profiler->report(std::cerr);
+    if (!traceFile.empty() && !TraceLog::write(traceFile))
+	   cout << "Trace could not be written to " << traceFile << endl;
     return 0;
 }